@@ -0,0 +1,168 @@
+#include "bench.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+	volatile double sink = 0;
+
+	/**
+	 * Runs faster than this are dominated by noise, their scaling is never reported as super-linear
+	 */
+	const double MIN_SCALING_SECONDS = 0.001;
+
+	std::string json_string(const std::string& str) {
+		std::string escaped = "\"";
+		for(char c : str) {
+			if(c == '"' || c == '\\') {
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped + "\"";
+	}
+
+	std::string json_number(double value) {
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+		return buffer;
+	}
+}
+
+daedalus::bench::Measurement daedalus::bench::measure(
+	std::string suite,
+	std::string name,
+	size_t parameter,
+	size_t items,
+	std::function<void ()> body,
+	double minSeconds
+) {
+	size_t iterations = 0;
+	double seconds = 0;
+
+	while(iterations == 0 || seconds < minSeconds) {
+		auto start = std::chrono::steady_clock::now();
+		body();
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		iterations++;
+	}
+
+	return daedalus::bench::Measurement{
+		suite,
+		name,
+		parameter,
+		iterations,
+		items,
+		seconds
+	};
+}
+
+std::vector<daedalus::bench::Scaling> daedalus::bench::compute_scaling(
+	const std::vector<daedalus::bench::Measurement>& measurements,
+	double maxExponent
+) {
+	std::vector<daedalus::bench::Scaling> scalings;
+
+	for(size_t i = 0; i < measurements.size(); i++) {
+		const daedalus::bench::Measurement& to = measurements[i];
+
+		// Previous measurement of the same benchmark
+		for(size_t j = i; j-- > 0;) {
+			const daedalus::bench::Measurement& from = measurements[j];
+			if(from.suite != to.suite || from.name != to.name) {
+				continue;
+			}
+			if(from.parameter >= to.parameter || from.seconds <= 0 || to.seconds <= 0) {
+				break;
+			}
+			double toSeconds = to.seconds / to.iterations;
+			double exponent = std::log(
+				toSeconds / (from.seconds / from.iterations)
+			) / std::log(static_cast<double>(to.parameter) / from.parameter);
+			scalings.push_back(daedalus::bench::Scaling{
+				to.suite,
+				to.name,
+				from.parameter,
+				to.parameter,
+				exponent,
+				exponent > maxExponent && toSeconds >= MIN_SCALING_SECONDS
+			});
+			break;
+		}
+	}
+
+	return scalings;
+}
+
+std::string daedalus::bench::repr(const daedalus::bench::Measurement& measurement) {
+	double perIteration = measurement.seconds / measurement.iterations;
+	char buffer[256];
+	std::snprintf(
+		buffer,
+		sizeof(buffer),
+		"%-10s %-40s %12zu %14.3f us/iter %10.3f ns/item",
+		measurement.suite.c_str(),
+		measurement.name.c_str(),
+		measurement.parameter,
+		perIteration * 1e6,
+		measurement.items == 0 ? 0 : perIteration * 1e9 / measurement.items
+	);
+	return buffer;
+}
+
+std::string daedalus::bench::repr(const daedalus::bench::Scaling& scaling) {
+	char buffer[256];
+	std::snprintf(
+		buffer,
+		sizeof(buffer),
+		"%-10s %-40s %12zu -> %-12zu exponent %6.2f%s",
+		scaling.suite.c_str(),
+		scaling.name.c_str(),
+		scaling.fromParameter,
+		scaling.toParameter,
+		scaling.exponent,
+		scaling.superLinear ? "  SUPER-LINEAR" : ""
+	);
+	return buffer;
+}
+
+std::string daedalus::bench::to_json(
+	const std::vector<daedalus::bench::Measurement>& measurements,
+	const std::vector<daedalus::bench::Scaling>& scalings
+) {
+	std::string json = "{\n\t\"measurements\": [";
+
+	for(size_t i = 0; i < measurements.size(); i++) {
+		const daedalus::bench::Measurement& measurement = measurements[i];
+		json += std::string(i == 0 ? "" : ",") + "\n\t\t{ " +
+			"\"suite\": " + json_string(measurement.suite) +
+			", \"name\": " + json_string(measurement.name) +
+			", \"parameter\": " + std::to_string(measurement.parameter) +
+			", \"iterations\": " + std::to_string(measurement.iterations) +
+			", \"items\": " + std::to_string(measurement.items) +
+			", \"seconds\": " + json_number(measurement.seconds) +
+			", \"secondsPerIteration\": " + json_number(measurement.seconds / measurement.iterations) +
+			" }";
+	}
+
+	json += "\n\t],\n\t\"scaling\": [";
+
+	for(size_t i = 0; i < scalings.size(); i++) {
+		const daedalus::bench::Scaling& scaling = scalings[i];
+		json += std::string(i == 0 ? "" : ",") + "\n\t\t{ " +
+			"\"suite\": " + json_string(scaling.suite) +
+			", \"name\": " + json_string(scaling.name) +
+			", \"fromParameter\": " + std::to_string(scaling.fromParameter) +
+			", \"toParameter\": " + std::to_string(scaling.toParameter) +
+			", \"exponent\": " + json_number(scaling.exponent) +
+			", \"superLinear\": " + (scaling.superLinear ? "true" : "false") +
+			" }";
+	}
+
+	return json + "\n\t]\n}\n";
+}
+
+void daedalus::bench::keep(double value) {
+	sink = value;
+}
@@ -0,0 +1,133 @@
+#ifndef __DAEDALUS_BENCH__
+#define __DAEDALUS_BENCH__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+	namespace bench {
+
+		/**
+		 * The timing of a benchmark
+		 */
+		typedef struct Measurement {
+			std::string suite;
+			std::string name;
+			/**
+			 * The size the benchmark was run with (elements, input bytes...)
+			 */
+			size_t parameter;
+			/**
+			 * Number of times the body was run
+			 */
+			size_t iterations;
+			/**
+			 * Number of items (elements, bytes...) processed by one run of the body
+			 */
+			size_t items;
+			/**
+			 * Total time spent in the body
+			 */
+			double seconds;
+		} Measurement;
+
+		/**
+		 * The growth of a benchmark time with its parameter
+		 */
+		typedef struct Scaling {
+			std::string suite;
+			std::string name;
+			size_t fromParameter;
+			size_t toParameter;
+			/**
+			 * `k` such that the time per run grows as `parameter^k` between both parameters
+			 */
+			double exponent;
+			/**
+			 * Whether the exponent is above the configured bound (runs under a millisecond are ignored)
+			 */
+			bool superLinear;
+		} Scaling;
+
+		typedef struct Options {
+			/**
+			 * Only run the suites whose name is listed (all of them when empty)
+			 */
+			std::vector<std::string> suites;
+			/**
+			 * Largest generated input for the pipeline suite
+			 */
+			size_t maxBytes = 1000000;
+			/**
+			 * Stop growing a pipeline input once a single run takes longer than this
+			 */
+			double timeLimit = 2;
+			/**
+			 * Exponent above which a scaling is reported as super-linear
+			 */
+			double maxExponent = 1.3;
+			/**
+			 * File to write the JSON results to (none when empty)
+			 */
+			std::string output;
+		} Options;
+
+		/**
+		 * Run a benchmark body
+		 * @param suite The suite the benchmark belongs to
+		 * @param name The name of the benchmark
+		 * @param parameter The size the benchmark is run with
+		 * @param items Number of items processed by one run of the body
+		 * @param body The code to time
+		 * @param minSeconds Minimum time to spend running the body (the body runs at least once)
+		 * @return The measurement
+		 */
+		Measurement measure(
+			std::string suite,
+			std::string name,
+			size_t parameter,
+			size_t items,
+			std::function<void ()> body,
+			double minSeconds = 0.2
+		);
+
+		/**
+		 * Compute the scaling between consecutive parameters of each benchmark
+		 * @param measurements The measurements, in increasing parameter order for each benchmark
+		 * @param maxExponent The exponent above which a scaling is super-linear
+		 */
+		std::vector<Scaling> compute_scaling(const std::vector<Measurement>& measurements, double maxExponent);
+
+		/**
+		 * Get the string representation of a measurement
+		 */
+		std::string repr(const Measurement& measurement);
+
+		/**
+		 * Get the string representation of a scaling
+		 */
+		std::string repr(const Scaling& scaling);
+
+		/**
+		 * Get the machine-readable representation of a benchmark run
+		 */
+		std::string to_json(const std::vector<Measurement>& measurements, const std::vector<Scaling>& scalings);
+
+		/**
+		 * Keep a value alive so the optimizer does not remove the code computing it
+		 */
+		void keep(double value);
+
+		void run_kernel_benchmarks(const Options& options, std::vector<Measurement>& measurements);
+
+		void run_lexer_benchmarks(const Options& options, std::vector<Measurement>& measurements);
+
+		void run_pipeline_benchmarks(const Options& options, std::vector<Measurement>& measurements);
+
+		void run_env_benchmarks(const Options& options, std::vector<Measurement>& measurements);
+	}
+}
+
+#endif // __DAEDALUS_BENCH__
@@ -0,0 +1,90 @@
+#include "bench.hpp"
+
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/values.hpp>
+
+#include <memory>
+#include <string>
+
+namespace {
+	double get_number(const std::shared_ptr<daedalus::core::values::RuntimeValue>& value) {
+		return static_cast<daedalus::core::values::NumberValue*>(value.get())->get();
+	}
+}
+
+void daedalus::bench::run_env_benchmarks(
+	const daedalus::bench::Options& options,
+	std::vector<daedalus::bench::Measurement>& measurements
+) {
+	// Every block scope pays for an empty environment, its size being part of the name
+	auto global = daedalus::core::env::make_environment({});
+	measurements.push_back(daedalus::bench::measure(
+		"env",
+		"empty scope (" + std::to_string(sizeof(daedalus::core::env::Environment)) + " B)",
+		0,
+		1,
+		[&] () {
+			auto scope = daedalus::core::env::make_environment({}, {}, global);
+			daedalus::bench::keep(scope->has_value("missing"));
+		}
+	));
+
+	// Most scopes (function bodies, blocks) hold a handful of variables, globals a few hundred at most
+	for(size_t size : { 1, 4, 8, 16, 64, 256 }) {
+		std::vector<std::string> keys;
+		std::vector<std::string> missingKeys;
+		std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> values;
+		for(size_t i = 0; i < size; i++) {
+			keys.push_back("variable_" + std::to_string(i));
+			missingKeys.push_back("missing_" + std::to_string(i));
+			values.push_back(std::make_shared<daedalus::core::values::NumberValue>(i));
+		}
+
+		auto env = daedalus::core::env::make_environment({});
+		for(size_t i = 0; i < size; i++) {
+			env->init_value(keys[i], values[i], {});
+		}
+
+		measurements.push_back(daedalus::bench::measure("env", "get_value", size, size, [&] () {
+			double sum = 0;
+			for(const std::string& key : keys) {
+				sum += get_number(env->get_value(key));
+			}
+			daedalus::bench::keep(sum);
+		}));
+
+		measurements.push_back(daedalus::bench::measure("env", "set_value", size, size, [&] () {
+			for(size_t i = 0; i < size; i++) {
+				env->set_value(keys[i], values[size - 1 - i]);
+			}
+		}));
+
+		measurements.push_back(daedalus::bench::measure("env", "has_value miss", size, size, [&] () {
+			size_t found = 0;
+			for(const std::string& key : missingKeys) {
+				found += env->has_value(key);
+			}
+			daedalus::bench::keep(found);
+		}));
+
+		// Identifiers are mostly resolved a few scopes up, from nested blocks
+		auto nested = daedalus::core::env::make_environment({}, {}, daedalus::core::env::make_environment({}, {}, daedalus::core::env::make_environment({}, {}, env)));
+		nested->init_value("local", values[0], {});
+
+		measurements.push_back(daedalus::bench::measure("env", "get_value 3 scopes up", size, size, [&] () {
+			double sum = 0;
+			for(const std::string& key : keys) {
+				sum += get_number(nested->get_value(key));
+			}
+			daedalus::bench::keep(sum);
+		}));
+
+		measurements.push_back(daedalus::bench::measure("env", "init_value in a new scope", size, size, [&] () {
+			auto scope = daedalus::core::env::make_environment({}, {}, env);
+			for(size_t i = 0; i < size; i++) {
+				scope->init_value(keys[i], values[i], {});
+			}
+			daedalus::bench::keep(get_number(scope->get_value(keys[0])));
+		}));
+	}
+}
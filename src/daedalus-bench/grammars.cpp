@@ -0,0 +1,367 @@
+#include "grammars.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace {
+	const std::vector<std::string> KEYWORDS = {
+		"let", "const", "if", "else", "while", "for", "return", "fn",
+		"struct", "enum", "match", "true", "false", "and", "or", "not",
+		"break", "continue", "import", "export", "type", "pub", "mut", "loop",
+		"yield", "async", "await", "static", "class", "trait", "impl", "where"
+	};
+
+	/**
+	 * A deterministic generator, independent from the standard library implementation
+	 */
+	class Random {
+	public:
+		uint32_t next(uint32_t bound) {
+			this->state = this->state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return static_cast<uint32_t>(this->state >> 33) % bound;
+		}
+
+	private:
+		uint64_t state = 42;
+	};
+
+	class BinaryExpression : public daedalus::core::ast::Expression {
+	public:
+		BinaryExpression(
+			std::shared_ptr<daedalus::core::ast::Expression> left,
+			char operation,
+			std::shared_ptr<daedalus::core::ast::Expression> right
+		) :
+			left(left),
+			right(right),
+			operation(operation)
+		{}
+
+		std::shared_ptr<daedalus::core::ast::Expression> left;
+		std::shared_ptr<daedalus::core::ast::Expression> right;
+		char operation;
+
+		virtual std::string type() override {
+			return "BinaryExpression";
+		}
+
+		virtual std::vector<std::shared_ptr<daedalus::core::ast::Expression>> get_children() override {
+			return { this->left, this->right };
+		}
+
+		virtual size_t get_footprint() override {
+			return sizeof(*this);
+		}
+
+		virtual std::shared_ptr<daedalus::core::ast::Expression> get_constexpr() override {
+			this->left = this->left->get_constexpr();
+			this->right = this->right->get_constexpr();
+
+			auto left = std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(this->left);
+			auto right = std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(this->right);
+			if(left != nullptr && right != nullptr) {
+				return std::make_shared<daedalus::core::ast::NumberExpression>(
+					compute(this->operation, left->get_value(), right->get_value())
+				);
+			}
+			return this->shared_from_this();
+		}
+
+		virtual std::string repr(int indent = 0) override {
+			return std::string(indent, '\t') + "(" + this->left->repr() + " " + this->operation + " " + this->right->repr() + ")";
+		}
+
+		static double compute(char operation, double left, double right) {
+			switch(operation) {
+				case '+': return left + right;
+				case '-': return left - right;
+				case '*': return left * right;
+				default: return left / right;
+			}
+		}
+	};
+
+	class KeywordStatement : public daedalus::core::ast::Expression {
+	public:
+		KeywordStatement(size_t count) : count(count) {}
+
+		size_t count;
+
+		virtual std::string type() override {
+			return "KeywordStatement";
+		}
+
+		virtual size_t get_footprint() override {
+			return sizeof(*this);
+		}
+
+		virtual std::shared_ptr<daedalus::core::ast::Expression> get_constexpr() override {
+			return this->shared_from_this();
+		}
+
+		virtual std::string repr(int indent = 0) override {
+			return std::string(indent, '\t') + std::to_string(this->count) + " keywords";
+		}
+	};
+
+	// * Arithmetic language
+
+	void setup_arithmetic_lexer(daedalus::core::lexer::Lexer& lexer) {
+		daedalus::core::lexer::setup_lexer(lexer, {
+			daedalus::core::lexer::make_token_type("OPERATOR", "+"),
+			daedalus::core::lexer::make_token_type("OPERATOR", "-"),
+			daedalus::core::lexer::make_token_type("OPERATOR", "*"),
+			daedalus::core::lexer::make_token_type("OPERATOR", "/"),
+			daedalus::core::lexer::make_token_type("("),
+			daedalus::core::lexer::make_token_type(")"),
+			daedalus::core::lexer::make_token_type("{"),
+			daedalus::core::lexer::make_token_type("}"),
+			daedalus::core::lexer::make_token_type(";"),
+			daedalus::core::lexer::make_number_token_type()
+		});
+	}
+
+	std::shared_ptr<daedalus::core::ast::Expression> parse_additive_expression(
+		daedalus::core::parser::Parser& parser,
+		std::vector<daedalus::core::lexer::Token>& tokens
+	);
+
+	std::shared_ptr<daedalus::core::ast::Expression> parse_primary_expression(
+		daedalus::core::parser::Parser& parser,
+		std::vector<daedalus::core::lexer::Token>& tokens
+	) {
+		if(peek(tokens).type == "(") {
+			(void)eat(tokens);
+			std::shared_ptr<daedalus::core::ast::Expression> expression = parse_additive_expression(parser, tokens);
+			(void)expect(tokens, ")", std::runtime_error("Expected )"));
+			return expression;
+		}
+		// A block evaluates to its last statement, its body being parsed when first evaluated
+		if(peek(tokens).type == "{") {
+			return daedalus::core::parser::parse_scope(parser, tokens);
+		}
+		return daedalus::core::parser::parse_number_expression(parser, tokens, false);
+	}
+
+	std::shared_ptr<daedalus::core::ast::Expression> parse_multiplicative_expression(
+		daedalus::core::parser::Parser& parser,
+		std::vector<daedalus::core::lexer::Token>& tokens
+	) {
+		std::shared_ptr<daedalus::core::ast::Expression> left = parse_primary_expression(parser, tokens);
+		while(peek(tokens).type == "OPERATOR" && (peek(tokens).value == "*" || peek(tokens).value == "/")) {
+			char operation = eat(tokens).value[0];
+			left = std::make_shared<BinaryExpression>(left, operation, parse_primary_expression(parser, tokens));
+		}
+		return left;
+	}
+
+	std::shared_ptr<daedalus::core::ast::Expression> parse_additive_expression(
+		daedalus::core::parser::Parser& parser,
+		std::vector<daedalus::core::lexer::Token>& tokens
+	) {
+		std::shared_ptr<daedalus::core::ast::Expression> left = parse_multiplicative_expression(parser, tokens);
+		while(peek(tokens).type == "OPERATOR" && (peek(tokens).value == "+" || peek(tokens).value == "-")) {
+			char operation = eat(tokens).value[0];
+			left = std::make_shared<BinaryExpression>(left, operation, parse_multiplicative_expression(parser, tokens));
+		}
+		return left;
+	}
+
+	void setup_arithmetic_parser(daedalus::core::parser::Parser& parser) {
+		daedalus::core::parser::setup_parser(parser, {}, {
+			daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR,
+			daedalus::core::parser::ParserFlags::LAZY_SCOPES
+		});
+		daedalus::core::parser::register_node(parser, "ArithmeticStatement", daedalus::core::parser::make_node(
+			[] (daedalus::core::parser::Parser& parser, std::vector<daedalus::core::lexer::Token>& tokens, bool needsSemicolon) -> std::shared_ptr<daedalus::core::ast::Expression> {
+				std::shared_ptr<daedalus::core::ast::Expression> expression = parse_additive_expression(parser, tokens);
+				if(needsSemicolon) {
+					(void)expect(tokens, ";", std::runtime_error("Expected ;"));
+				}
+				return expression;
+			}
+		));
+		daedalus::core::parser::demoteTopNode(parser, "NumberExpression");
+	}
+
+	double get_number(const std::shared_ptr<daedalus::core::values::RuntimeValue>& value) {
+		auto number = std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(value);
+		DAE_ASSERT_TRUE(
+			number != nullptr,
+			std::runtime_error("Expected a NumberValue, got " + value->type())
+		)
+		return number->get();
+	}
+
+	void setup_arithmetic_interpreter(daedalus::core::interpreter::Interpreter& interpreter) {
+		daedalus::core::interpreter::setup_interpreter(interpreter, {
+			{
+				"BinaryExpression",
+				[] (daedalus::core::interpreter::Interpreter& interpreter, std::shared_ptr<daedalus::core::ast::Statement> statement, std::shared_ptr<daedalus::core::env::Environment> env) -> daedalus::core::interpreter::RuntimeValueWrapper {
+					auto expression = std::static_pointer_cast<BinaryExpression>(statement);
+					double left = get_number(daedalus::core::interpreter::evaluate_statement(interpreter, expression->left, env).value);
+					double right = get_number(daedalus::core::interpreter::evaluate_statement(interpreter, expression->right, env).value);
+					return daedalus::core::interpreter::wrap(daedalus::core::values::make_value<daedalus::core::values::NumberValue>(
+						BinaryExpression::compute(expression->operation, left, right)
+					));
+				}
+			},
+			{
+				"Scope",
+				[] (daedalus::core::interpreter::Interpreter& interpreter, std::shared_ptr<daedalus::core::ast::Statement> statement, std::shared_ptr<daedalus::core::env::Environment> env) -> daedalus::core::interpreter::RuntimeValueWrapper {
+					std::vector<daedalus::core::interpreter::RuntimeResult> results;
+					return daedalus::core::interpreter::evaluate_scope(interpreter, std::static_pointer_cast<daedalus::core::ast::Scope>(statement), results, nullptr, env);
+				}
+			}
+		}, {}, {});
+	}
+
+	void append_arithmetic_expression(std::string& src, Random& random, size_t depth) {
+		if(depth > 1 && random.next(16) == 0) {
+			src += "{ ";
+			append_arithmetic_expression(src, random, depth - 2);
+			src += "; ";
+			append_arithmetic_expression(src, random, depth - 2);
+			src += "; }";
+			return;
+		}
+		if(depth == 0 || random.next(3) == 0) {
+			src += std::to_string(random.next(1000));
+			if(random.next(4) == 0) {
+				src += "." + std::to_string(random.next(100));
+			}
+			return;
+		}
+
+		bool parenthesized = random.next(2) == 0;
+		if(parenthesized) {
+			src += "(";
+		}
+		append_arithmetic_expression(src, random, depth - 1);
+		src += std::string(" ") + "+-*/"[random.next(4)] + " ";
+		append_arithmetic_expression(src, random, depth - 1);
+		if(parenthesized) {
+			src += ")";
+		}
+	}
+
+	std::string generate_arithmetic(size_t bytes, Random& random, size_t commentRatio) {
+		std::string src = "";
+		src.reserve(bytes + 256);
+
+		while(src.size() < bytes) {
+			if(commentRatio != 0) {
+				size_t commentBytes = commentRatio * 8 + random.next(commentRatio * 8);
+				if(random.next(2) == 0) {
+					src += "// " + std::string(commentBytes, 'c') + "\n";
+				} else {
+					src += "/* " + std::string(commentBytes / 2, 'c') + "\n" + std::string(commentBytes / 2, 'c') + " */\n";
+				}
+			}
+			append_arithmetic_expression(src, random, 4);
+			src += ";\n";
+		}
+
+		return src;
+	}
+
+	// * Keyword language
+
+	void setup_keyword_lexer(daedalus::core::lexer::Lexer& lexer) {
+		std::vector<daedalus::core::lexer::TokenType> tokenTypes;
+		for(const std::string& keyword : KEYWORDS) {
+			tokenTypes.push_back(daedalus::core::lexer::make_token_type("KEYWORD", keyword));
+		}
+		tokenTypes.push_back(daedalus::core::lexer::make_token_type(";"));
+		daedalus::core::lexer::setup_lexer(lexer, tokenTypes);
+	}
+
+	void setup_keyword_parser(daedalus::core::parser::Parser& parser) {
+		daedalus::core::parser::setup_parser(parser, {});
+		daedalus::core::parser::register_node(parser, "KeywordStatement", daedalus::core::parser::make_node(
+			[] (daedalus::core::parser::Parser& parser, std::vector<daedalus::core::lexer::Token>& tokens, bool needsSemicolon) -> std::shared_ptr<daedalus::core::ast::Expression> {
+				size_t count = 0;
+				while(peek(tokens).type == "KEYWORD") {
+					(void)eat(tokens);
+					count++;
+				}
+				if(needsSemicolon) {
+					(void)expect(tokens, ";", std::runtime_error("Expected ;"));
+				}
+				return std::make_shared<KeywordStatement>(count);
+			}
+		));
+		daedalus::core::parser::demoteTopNode(parser, "NumberExpression");
+	}
+
+	void setup_keyword_interpreter(daedalus::core::interpreter::Interpreter& interpreter) {
+		daedalus::core::interpreter::setup_interpreter(interpreter, {
+			{
+				"KeywordStatement",
+				[] (daedalus::core::interpreter::Interpreter& interpreter, std::shared_ptr<daedalus::core::ast::Statement> statement, std::shared_ptr<daedalus::core::env::Environment> env) -> daedalus::core::interpreter::RuntimeValueWrapper {
+					return daedalus::core::interpreter::wrap(daedalus::core::values::make_value<daedalus::core::values::NumberValue>(
+						static_cast<double>(std::static_pointer_cast<KeywordStatement>(statement)->count)
+					));
+				}
+			}
+		}, {}, {});
+	}
+}
+
+daedalus::bench::Grammar daedalus::bench::arithmetic_grammar() {
+	return daedalus::bench::Grammar{
+		"arithmetic",
+		[] () {
+			return daedalus::core::setup_daedalus(&setup_arithmetic_lexer, &setup_arithmetic_parser, &setup_arithmetic_interpreter);
+		},
+		[] (size_t bytes) {
+			Random random;
+			return generate_arithmetic(bytes, random, 0);
+		}
+	};
+}
+
+daedalus::bench::Grammar daedalus::bench::keyword_grammar() {
+	return daedalus::bench::Grammar{
+		"keywords",
+		[] () {
+			return daedalus::core::setup_daedalus(&setup_keyword_lexer, &setup_keyword_parser, &setup_keyword_interpreter);
+		},
+		[] (size_t bytes) {
+			Random random;
+			std::string src = "";
+			src.reserve(bytes + 256);
+
+			while(src.size() < bytes) {
+				size_t count = 1 + random.next(12);
+				for(size_t i = 0; i < count; i++) {
+					src += KEYWORDS[random.next(KEYWORDS.size())] + " ";
+				}
+				src += ";\n";
+			}
+
+			return src;
+		}
+	};
+}
+
+daedalus::bench::Grammar daedalus::bench::comment_grammar() {
+	return daedalus::bench::Grammar{
+		"comments",
+		[] () {
+			return daedalus::core::setup_daedalus(&setup_arithmetic_lexer, &setup_arithmetic_parser, &setup_arithmetic_interpreter);
+		},
+		[] (size_t bytes) {
+			Random random;
+			return generate_arithmetic(bytes, random, 8);
+		}
+	};
+}
+
+std::vector<daedalus::bench::Grammar> daedalus::bench::reference_grammars() {
+	return {
+		daedalus::bench::arithmetic_grammar(),
+		daedalus::bench::keyword_grammar(),
+		daedalus::bench::comment_grammar()
+	};
+}
@@ -0,0 +1,46 @@
+#ifndef __DAEDALUS_BENCH_GRAMMARS__
+#define __DAEDALUS_BENCH_GRAMMARS__
+
+#include <daedalus/core/core.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+	namespace bench {
+
+		/**
+		 * A reference language and a generator of programs written in it
+		 */
+		typedef struct Grammar {
+			std::string name;
+			std::function<daedalus::core::Daedalus ()> setup;
+			/**
+			 * Generate a valid program of about `bytes` characters
+			 * @note The output only depends on `bytes`, so runs stay comparable across commits
+			 */
+			std::function<std::string (size_t bytes)> generate;
+		} Grammar;
+
+		/**
+		 * Arithmetic statements over numbers and lazily parsed blocks (`1.5 + { 2; 3 * 4; } / 4;`)
+		 */
+		Grammar arithmetic_grammar();
+
+		/**
+		 * Statements made of keywords only, with many keyword token types to try
+		 */
+		Grammar keyword_grammar();
+
+		/**
+		 * Arithmetic statements buried in single-line and multi-line comments
+		 */
+		Grammar comment_grammar();
+
+		std::vector<Grammar> reference_grammars();
+	}
+}
+
+#endif // __DAEDALUS_BENCH_GRAMMARS__
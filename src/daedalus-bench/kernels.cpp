@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/kernels.hpp>
+
+#include <memory>
+
+namespace {
+	std::shared_ptr<daedalus::core::values::RuntimeValue> add_scalar_values(
+		std::shared_ptr<daedalus::core::values::RuntimeValue> left,
+		std::shared_ptr<daedalus::core::values::RuntimeValue> right
+	) {
+		return std::make_shared<daedalus::core::values::NumberValue>(
+			std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(left)->get() +
+			std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(right)->get()
+		);
+	}
+}
+
+void daedalus::bench::run_kernel_benchmarks(
+	const daedalus::bench::Options& options,
+	std::vector<daedalus::bench::Measurement>& measurements
+) {
+	for(size_t size : { 1024, 65536, 1048576 }) {
+		// * Scalar path : one RuntimeValue per element
+
+		std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> left;
+		std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> right;
+		for(size_t i = 0; i < size; i++) {
+			left.push_back(std::make_shared<daedalus::core::values::NumberValue>(i));
+			right.push_back(std::make_shared<daedalus::core::values::NumberValue>(size - i));
+		}
+
+		measurements.push_back(daedalus::bench::measure("kernels", "add NumberValue", size, size, [&] () {
+			std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> out(size);
+			for(size_t i = 0; i < size; i++) {
+				out[i] = add_scalar_values(left[i], right[i]);
+			}
+			daedalus::bench::keep(std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(out.back())->get());
+		}));
+
+		measurements.push_back(daedalus::bench::measure("kernels", "sum NumberValue", size, size, [&] () {
+			double sum = 0;
+			for(size_t i = 0; i < size; i++) {
+				sum += std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(left[i])->get();
+			}
+			daedalus::bench::keep(sum);
+		}));
+
+		// * Vector path, for each backend
+
+		auto leftVector = std::make_shared<daedalus::core::values::NumberVectorValue>(size);
+		auto rightVector = std::make_shared<daedalus::core::values::NumberVectorValue>(size);
+		for(size_t i = 0; i < size; i++) {
+			leftVector->get()[i] = i;
+			rightVector->get()[i] = size - i;
+		}
+
+		for(daedalus::core::kernels::KernelBackend backend : { daedalus::core::kernels::KernelBackend::SCALAR, daedalus::core::kernels::KernelBackend::AVX2 }) {
+			daedalus::core::kernels::set_backend(backend);
+			if(daedalus::core::kernels::get_backend() != backend) {
+				continue;
+			}
+			std::string backendName = backend == daedalus::core::kernels::KernelBackend::AVX2 ? " avx2" : " scalar";
+
+			measurements.push_back(daedalus::bench::measure("kernels", "add NumberVectorValue" + backendName, size, size, [&] () {
+				auto out = daedalus::core::kernels::apply_vector_operation(daedalus::core::kernels::VectorOperation::ADD, leftVector, rightVector);
+				daedalus::bench::keep(std::static_pointer_cast<daedalus::core::values::NumberVectorValue>(out)->get().back());
+			}));
+
+			measurements.push_back(daedalus::bench::measure("kernels", "lt NumberVectorValue" + backendName, size, size, [&] () {
+				auto out = daedalus::core::kernels::apply_vector_operation(daedalus::core::kernels::VectorOperation::LT, leftVector, rightVector);
+				daedalus::bench::keep(std::static_pointer_cast<daedalus::core::values::NumberVectorValue>(out)->get().back());
+			}));
+
+			measurements.push_back(daedalus::bench::measure("kernels", "sum NumberVectorValue" + backendName, size, size, [&] () {
+				daedalus::bench::keep(daedalus::core::kernels::reduce(daedalus::core::kernels::VectorReduction::SUM, leftVector->get().data(), size));
+			}));
+		}
+
+		daedalus::core::kernels::set_backend(daedalus::core::kernels::KernelBackend::AUTO);
+	}
+}
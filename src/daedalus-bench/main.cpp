@@ -0,0 +1,86 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+	void print_usage() {
+		std::cout <<
+			"Usage: daedalus-bench [options]\n"
+			"  --suite <name>          Only run a suite (kernels, lexer, pipeline, env), can be repeated\n"
+			"  --max-bytes <n>         Largest generated pipeline input (default 1000000, at most 100000000)\n"
+			"  --time-limit <seconds>  Stop growing an input once a run takes longer (default 2)\n"
+			"  --max-exponent <k>      Report scalings above parameter^k as super-linear (default 1.3)\n"
+			"  --output <file>         Write the results as JSON\n"
+			"  --strict                Exit with 1 when a scaling is super-linear\n";
+	}
+
+	bool should_run(const daedalus::bench::Options& options, const std::string& suite) {
+		return options.suites.empty() || std::find(options.suites.begin(), options.suites.end(), suite) != options.suites.end();
+	}
+}
+
+int main(int argc, char** argv) {
+	daedalus::bench::Options options;
+	bool strict = false;
+
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if(arg == "--suite" && hasValue) {
+			options.suites.push_back(argv[++i]);
+		} else if(arg == "--max-bytes" && hasValue) {
+			options.maxBytes = std::strtoull(argv[++i], nullptr, 10);
+		} else if(arg == "--time-limit" && hasValue) {
+			options.timeLimit = std::strtod(argv[++i], nullptr);
+		} else if(arg == "--max-exponent" && hasValue) {
+			options.maxExponent = std::strtod(argv[++i], nullptr);
+		} else if(arg == "--output" && hasValue) {
+			options.output = argv[++i];
+		} else if(arg == "--strict") {
+			strict = true;
+		} else {
+			print_usage();
+			return arg == "--help" ? 0 : 2;
+		}
+	}
+
+	std::vector<daedalus::bench::Measurement> measurements;
+
+	if(should_run(options, "kernels")) {
+		daedalus::bench::run_kernel_benchmarks(options, measurements);
+	}
+	if(should_run(options, "lexer")) {
+		daedalus::bench::run_lexer_benchmarks(options, measurements);
+	}
+	if(should_run(options, "pipeline")) {
+		daedalus::bench::run_pipeline_benchmarks(options, measurements);
+	}
+	if(should_run(options, "env")) {
+		daedalus::bench::run_env_benchmarks(options, measurements);
+	}
+
+	for(const daedalus::bench::Measurement& measurement : measurements) {
+		std::cout << daedalus::bench::repr(measurement) << std::endl;
+	}
+
+	std::vector<daedalus::bench::Scaling> scalings = daedalus::bench::compute_scaling(measurements, options.maxExponent);
+	bool superLinear = false;
+
+	std::cout << std::endl;
+	for(const daedalus::bench::Scaling& scaling : scalings) {
+		std::cout << daedalus::bench::repr(scaling) << std::endl;
+		superLinear = superLinear || scaling.superLinear;
+	}
+
+	if(!options.output.empty()) {
+		std::ofstream output(options.output);
+		output << daedalus::bench::to_json(measurements, scalings);
+	}
+
+	return strict && superLinear ? 1 : 0;
+}
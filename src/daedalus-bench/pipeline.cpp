@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "grammars.hpp"
+
+#include <algorithm>
+
+namespace {
+	const size_t MIN_BYTES = 1024;
+	const size_t MAX_BYTES = 100000000;
+	const size_t BYTES_GROWTH = 4;
+	const double MIN_SECONDS = 0.2;
+}
+
+void daedalus::bench::run_pipeline_benchmarks(
+	const daedalus::bench::Options& options,
+	std::vector<daedalus::bench::Measurement>& measurements
+) {
+	size_t maxBytes = std::min(options.maxBytes, MAX_BYTES);
+
+	for(const daedalus::bench::Grammar& grammar : daedalus::bench::reference_grammars()) {
+		daedalus::core::Daedalus daedalus = grammar.setup();
+
+		for(size_t bytes = MIN_BYTES; bytes <= maxBytes; bytes = bytes * BYTES_GROWTH > maxBytes && bytes != maxBytes ? maxBytes : bytes * BYTES_GROWTH) {
+			std::string src = grammar.generate(bytes);
+
+			// Every stage is timed by the same runs, repeated while they are too short to be measured reliably
+			size_t iterations = 0;
+			double total = 0;
+			double slowest = 0;
+			double stages[4] = { 0, 0, 0, 0 };
+
+			while(iterations == 0 || total < MIN_SECONDS) {
+				std::vector<daedalus::core::interpreter::RuntimeResult> results;
+				daedalus::core::PipelineMetrics metrics = daedalus::core::run(daedalus, results, src);
+
+				double run = metrics.lexSeconds + metrics.parseSeconds + metrics.optimizeSeconds + metrics.interpretSeconds;
+				stages[0] += metrics.lexSeconds;
+				stages[1] += metrics.parseSeconds;
+				stages[2] += metrics.optimizeSeconds;
+				stages[3] += metrics.interpretSeconds;
+				total += run;
+				slowest = std::max(slowest, run);
+				iterations++;
+			}
+
+			const char* names[4] = { "lex", "parse", "fold", "interpret" };
+			for(size_t stage = 0; stage < 4; stage++) {
+				measurements.push_back(daedalus::bench::Measurement{
+					"pipeline",
+					grammar.name + " " + names[stage],
+					bytes,
+					iterations,
+					src.size(),
+					stages[stage]
+				});
+			}
+
+			// Larger inputs would not finish in a reasonable time, the scaling already shows why
+			if(slowest > options.timeLimit || bytes == maxBytes) {
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#include "bench.hpp"
+#include "grammars.hpp"
+
+#include <daedalus/core/lexer/static_tokens.hpp>
+
+#include <cctype>
+
+namespace {
+	DAE_STATIC_TOKEN(Let, "KEYWORD", "let")
+	DAE_STATIC_TOKEN(Const, "KEYWORD", "const")
+	DAE_STATIC_TOKEN(If, "KEYWORD", "if")
+	DAE_STATIC_TOKEN(Else, "KEYWORD", "else")
+	DAE_STATIC_TOKEN(While, "KEYWORD", "while")
+	DAE_STATIC_TOKEN(For, "KEYWORD", "for")
+	DAE_STATIC_TOKEN(Return, "KEYWORD", "return")
+	DAE_STATIC_TOKEN(Fn, "KEYWORD", "fn")
+	DAE_STATIC_TOKEN(Struct, "KEYWORD", "struct")
+	DAE_STATIC_TOKEN(Enum, "KEYWORD", "enum")
+	DAE_STATIC_TOKEN(Match, "KEYWORD", "match")
+	DAE_STATIC_TOKEN(True, "KEYWORD", "true")
+	DAE_STATIC_TOKEN(False, "KEYWORD", "false")
+	DAE_STATIC_TOKEN(And, "KEYWORD", "and")
+	DAE_STATIC_TOKEN(Or, "KEYWORD", "or")
+	DAE_STATIC_TOKEN(Not, "KEYWORD", "not")
+	DAE_STATIC_TOKEN(Break, "KEYWORD", "break")
+	DAE_STATIC_TOKEN(Continue, "KEYWORD", "continue")
+	DAE_STATIC_TOKEN(Import, "KEYWORD", "import")
+	DAE_STATIC_TOKEN(Export, "KEYWORD", "export")
+	DAE_STATIC_TOKEN(Type, "KEYWORD", "type")
+	DAE_STATIC_TOKEN(Pub, "KEYWORD", "pub")
+	DAE_STATIC_TOKEN(Mut, "KEYWORD", "mut")
+	DAE_STATIC_TOKEN(Loop, "KEYWORD", "loop")
+	DAE_STATIC_TOKEN(Yield, "KEYWORD", "yield")
+	DAE_STATIC_TOKEN(Async, "KEYWORD", "async")
+	DAE_STATIC_TOKEN(Await, "KEYWORD", "await")
+	DAE_STATIC_TOKEN(Static, "KEYWORD", "static")
+	DAE_STATIC_TOKEN(Class, "KEYWORD", "class")
+	DAE_STATIC_TOKEN(Trait, "KEYWORD", "trait")
+	DAE_STATIC_TOKEN(Impl, "KEYWORD", "impl")
+	DAE_STATIC_TOKEN(Where, "KEYWORD", "where")
+	DAE_STATIC_TOKEN(Semicolon, ";", ";")
+
+	DAE_STATIC_TOKEN(Plus, "OPERATOR", "+")
+	DAE_STATIC_TOKEN(Minus, "OPERATOR", "-")
+	DAE_STATIC_TOKEN(Times, "OPERATOR", "*")
+	DAE_STATIC_TOKEN(Divide, "OPERATOR", "/")
+	DAE_STATIC_TOKEN(OpenParen, "(", "(")
+	DAE_STATIC_TOKEN(CloseParen, ")", ")")
+	DAE_STATIC_TOKEN(OpenBrace, "{", "{")
+	DAE_STATIC_TOKEN(CloseBrace, "}", "}")
+
+	struct Number {
+		static constexpr std::string_view name = "NUMBER";
+		static constexpr std::string_view firstBytes = "0123456789";
+
+		static size_t match(std::string_view src, daedalus::core::lexer::TokenPayload& payload) {
+			size_t length = 0;
+			while(length < src.length() && (std::isdigit(static_cast<unsigned char>(src[length])) || src[length] == '.')) {
+				length++;
+			}
+			return length;
+		}
+	};
+
+	typedef daedalus::core::lexer::StaticTokenSet<
+		Let, Const, If, Else, While, For, Return, Fn,
+		Struct, Enum, Match, True, False, And, Or, Not,
+		Break, Continue, Import, Export, Type, Pub, Mut, Loop,
+		Yield, Async, Await, Static, Class, Trait, Impl, Where,
+		Semicolon
+	> KeywordTokens;
+
+	typedef daedalus::core::lexer::StaticTokenSet<
+		Plus, Minus, Times, Divide, OpenParen, CloseParen, OpenBrace, CloseBrace, Semicolon, Number
+	> ArithmeticTokens;
+
+	template<typename TokenSet>
+	void compare_lexers(
+		const daedalus::bench::Grammar& grammar,
+		std::vector<daedalus::bench::Measurement>& measurements
+	) {
+		daedalus::core::lexer::Lexer runtimeLexer = grammar.setup().lexer;
+		daedalus::core::lexer::Lexer staticLexer = daedalus::core::lexer::Lexer();
+		daedalus::core::lexer::use_static_tokens<TokenSet>(staticLexer);
+
+		for(size_t bytes : { 1024, 4096, 16384 }) {
+			std::string src = grammar.generate(bytes);
+
+			measurements.push_back(daedalus::bench::measure("lexer", grammar.name + " std::function", bytes, src.size(), [&] () {
+				std::vector<daedalus::core::lexer::Token> tokens;
+				daedalus::core::lexer::lex(runtimeLexer, tokens, src);
+				daedalus::bench::keep(static_cast<double>(tokens.size()));
+			}));
+			measurements.push_back(daedalus::bench::measure("lexer", grammar.name + " static", bytes, src.size(), [&] () {
+				std::vector<daedalus::core::lexer::Token> tokens;
+				daedalus::core::lexer::lex(staticLexer, tokens, src);
+				daedalus::bench::keep(static_cast<double>(tokens.size()));
+			}));
+		}
+	}
+}
+
+void daedalus::bench::run_lexer_benchmarks(
+	const daedalus::bench::Options& options,
+	std::vector<daedalus::bench::Measurement>& measurements
+) {
+	compare_lexers<KeywordTokens>(daedalus::bench::keyword_grammar(), measurements);
+	compare_lexers<ArithmeticTokens>(daedalus::bench::arithmetic_grammar(), measurements);
+}
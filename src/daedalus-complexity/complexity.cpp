@@ -0,0 +1,319 @@
+#include "complexity.hpp"
+
+#include <daedalus/core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace {
+	const char* STAGE_NAMES[DAE_COMPLEXITY_STAGE_COUNT] = { "lex", "parse", "interpret" };
+
+	/**
+	 * Stages faster than this are dominated by noise, they are left out of the time fits
+	 */
+	const double MIN_FIT_SECONDS = 0.0002;
+
+	/**
+	 * Stages allocating less than this are dominated by their fixed costs, they are left out of the allocation fits
+	 */
+	const size_t MIN_FIT_ALLOCATIONS = 64;
+
+	const size_t MIN_RUNS = 3;
+
+	/**
+	 * Largest deeply nested input, each level being recursed into by the parser and the interpreter
+	 */
+	const size_t MAX_NESTING_BYTES = 16 * 1024;
+
+	double log_slope(const std::vector<std::pair<double, double>>& points) {
+		if(points.size() < 3) {
+			return 0;
+		}
+
+		double meanX = 0;
+		double meanY = 0;
+		for(const auto& [x, y] : points) {
+			meanX += std::log(x);
+			meanY += std::log(y);
+		}
+		meanX /= points.size();
+		meanY /= points.size();
+
+		double covariance = 0;
+		double variance = 0;
+		for(const auto& [x, y] : points) {
+			covariance += (std::log(x) - meanX) * (std::log(y) - meanY);
+			variance += (std::log(x) - meanX) * (std::log(x) - meanX);
+		}
+		return variance == 0 ? 0 : covariance / variance;
+	}
+
+	double local_exponent(double fromX, double fromY, double toX, double toY) {
+		return std::log(toY / fromY) / std::log(toX / fromX);
+	}
+
+	bool timed(const daedalus::complexity::Sample& sample, size_t stage) {
+		return sample.seconds[stage] >= MIN_FIT_SECONDS;
+	}
+
+	bool counted(const daedalus::complexity::Sample& sample, size_t stage) {
+		return sample.allocations[stage] >= MIN_FIT_ALLOCATIONS;
+	}
+
+	/**
+	 * Get the size of the first sample growing faster than the bound from the previous one, in the measures whose fit
+	 * exceeded it
+	 * @note Without such a step, the growth is spread over the fit, its first sample being the smallest one showing it
+	 */
+	size_t find_offending_bytes(
+		const std::vector<daedalus::complexity::Sample>& samples,
+		size_t stage,
+		double maxExponent,
+		bool time,
+		bool allocations
+	) {
+		for(size_t i = 1; i < samples.size(); i++) {
+			const daedalus::complexity::Sample& from = samples[i - 1];
+			const daedalus::complexity::Sample& to = samples[i];
+
+			if(time && timed(from, stage) && timed(to, stage) && local_exponent(from.bytes, from.seconds[stage], to.bytes, to.seconds[stage]) > maxExponent) {
+				return to.bytes;
+			}
+			if(allocations && counted(from, stage) && counted(to, stage) && local_exponent(from.bytes, from.allocations[stage], to.bytes, to.allocations[stage]) > maxExponent) {
+				return to.bytes;
+			}
+		}
+
+		for(const daedalus::complexity::Sample& sample : samples) {
+			if((time && timed(sample, stage)) || (allocations && counted(sample, stage))) {
+				return sample.bytes;
+			}
+		}
+		return 0;
+	}
+
+	std::string save_input(
+		const daedalus::complexity::Target& target,
+		const std::string& stage,
+		size_t bytes,
+		const std::string& directory
+	) {
+		std::filesystem::create_directories(directory);
+		std::filesystem::path path = std::filesystem::path(directory) / (target.grammar.name + "-" + stage + "-" + std::to_string(bytes) + ".txt");
+
+		std::ofstream file(path, std::ios::binary);
+		file << target.grammar.generate(bytes);
+		return path.string();
+	}
+}
+
+std::vector<daedalus::complexity::Target> daedalus::complexity::default_targets() {
+	daedalus::bench::Grammar arithmetic = daedalus::bench::arithmetic_grammar();
+	daedalus::bench::Grammar keywords = daedalus::bench::keyword_grammar();
+
+	return {
+		daedalus::complexity::Target{ arithmetic, 0 },
+		daedalus::complexity::Target{ keywords, 0 },
+		daedalus::complexity::Target{ daedalus::bench::comment_grammar(), 0 },
+		daedalus::complexity::Target{
+			daedalus::bench::Grammar{
+				"long-comment",
+				arithmetic.setup,
+				[] (size_t bytes) {
+					// A single comment spanning the whole input, line breaks included
+					std::string src = "/* ";
+					while(src.size() + 16 < bytes) {
+						src += src.size() % 64 == 3 ? '\n' : 'c';
+					}
+					return src + " */\n1 + 2;\n";
+				}
+			},
+			0
+		},
+		daedalus::complexity::Target{
+			daedalus::bench::Grammar{
+				"long-statement",
+				keywords.setup,
+				[] (size_t bytes) {
+					// A single statement, every token being eaten by the same node
+					const std::string words[4] = { "let ", "const ", "while ", "return " };
+					std::string src = "";
+					for(size_t i = 0; src.size() + 8 < bytes; i++) {
+						src += words[i % 4];
+					}
+					return src + ";\n";
+				}
+			},
+			0
+		},
+		daedalus::complexity::Target{
+			daedalus::bench::Grammar{
+				"deep-nesting",
+				[setup = arithmetic.setup] () {
+					// Without folding, the interpreter recurses through every level too
+					daedalus::core::Daedalus daedalus = setup();
+					daedalus.parser.flags.erase(
+						std::remove(daedalus.parser.flags.begin(), daedalus.parser.flags.end(), daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR),
+						daedalus.parser.flags.end()
+					);
+					return daedalus;
+				},
+				[] (size_t bytes) {
+					size_t depth = std::max<size_t>(bytes / 6, 1);
+					std::string src = "";
+					for(size_t i = 0; i < depth; i++) {
+						src += "(1 + ";
+					}
+					src += "1";
+					src += std::string(depth, ')');
+					return src + ";\n";
+				}
+			},
+			MAX_NESTING_BYTES
+		}
+	};
+}
+
+std::vector<daedalus::complexity::Sample> daedalus::complexity::sample_target(
+	const daedalus::complexity::Target& target,
+	const daedalus::complexity::Options& options
+) {
+	daedalus::core::Daedalus daedalus = target.grammar.setup();
+	daedalus.allocationTracker = std::make_shared<daedalus::core::tools::AllocationTracker>();
+
+	size_t growth = std::max<size_t>(options.growth, 2);
+	size_t maxBytes = target.maxBytes != 0 ? std::min(target.maxBytes, options.maxBytes) : options.maxBytes;
+	std::vector<daedalus::complexity::Sample> samples;
+
+	for(size_t bytes = std::max<size_t>(options.minBytes, 1); bytes <= maxBytes; bytes *= growth) {
+		std::string src = target.grammar.generate(bytes);
+		daedalus::complexity::Sample sample = daedalus::complexity::Sample{ bytes, { 0, 0, 0 }, { 0, 0, 0 } };
+
+		// The fastest run is kept, slower ones being the machine's noise rather than the input's cost
+		double total = 0;
+		double slowest = 0;
+		for(size_t runs = 0; runs < MIN_RUNS || (total < options.minSeconds && slowest < options.timeLimit); runs++) {
+			std::vector<daedalus::core::interpreter::RuntimeResult> results;
+			daedalus::core::PipelineMetrics metrics = daedalus::core::run(daedalus, results, src);
+
+			// Constant folding is part of the parse stage, as when `parse` runs it itself
+			double seconds[DAE_COMPLEXITY_STAGE_COUNT] = { metrics.lexSeconds, metrics.parseSeconds + metrics.optimizeSeconds, metrics.interpretSeconds };
+			size_t allocations[DAE_COMPLEXITY_STAGE_COUNT] = {
+				daedalus.allocationTracker->get_phase(daedalus::core::tools::PipelinePhase::LEXER).allocations,
+				daedalus.allocationTracker->get_phase(daedalus::core::tools::PipelinePhase::PARSER).allocations +
+					daedalus.allocationTracker->get_phase(daedalus::core::tools::PipelinePhase::OPTIMIZER).allocations,
+				daedalus.allocationTracker->get_phase(daedalus::core::tools::PipelinePhase::INTERPRETER).allocations
+			};
+			for(size_t stage = 0; stage < DAE_COMPLEXITY_STAGE_COUNT; stage++) {
+				sample.seconds[stage] = runs == 0 ? seconds[stage] : std::min(sample.seconds[stage], seconds[stage]);
+				sample.allocations[stage] = allocations[stage];
+			}
+
+			double run = metrics.lexSeconds + metrics.parseSeconds + metrics.optimizeSeconds + metrics.interpretSeconds;
+			total += run;
+			slowest = std::max(slowest, run);
+			if(slowest > options.timeLimit) {
+				break;
+			}
+		}
+
+		samples.push_back(sample);
+
+		// Larger inputs would not finish in a reasonable time, the samples already show why
+		if(slowest > options.timeLimit || bytes > maxBytes / growth) {
+			break;
+		}
+	}
+
+	return samples;
+}
+
+std::vector<daedalus::complexity::Fit> daedalus::complexity::fit_target(
+	const daedalus::complexity::Target& target,
+	const std::vector<daedalus::complexity::Sample>& samples,
+	const daedalus::complexity::Options& options
+) {
+	std::vector<daedalus::complexity::Fit> fits;
+
+	for(size_t stage = 0; stage < DAE_COMPLEXITY_STAGE_COUNT; stage++) {
+		std::vector<std::pair<double, double>> times;
+		std::vector<std::pair<double, double>> allocations;
+		for(const daedalus::complexity::Sample& sample : samples) {
+			if(timed(sample, stage)) {
+				times.emplace_back(sample.bytes, sample.seconds[stage]);
+			}
+			if(counted(sample, stage)) {
+				allocations.emplace_back(sample.bytes, sample.allocations[stage]);
+			}
+		}
+
+		daedalus::complexity::Fit fit = daedalus::complexity::Fit{
+			target.grammar.name,
+			STAGE_NAMES[stage],
+			log_slope(times),
+			log_slope(allocations),
+			false,
+			0,
+			""
+		};
+		bool superLinearTime = fit.timeExponent > options.maxExponent;
+		bool superLinearAllocations = fit.allocationExponent > options.maxExponent;
+		fit.superLinear = superLinearTime || superLinearAllocations;
+
+		if(fit.superLinear) {
+			fit.offendingBytes = find_offending_bytes(samples, stage, options.maxExponent, superLinearTime, superLinearAllocations);
+			if(!options.saveDirectory.empty()) {
+				fit.savedPath = save_input(target, fit.stage, fit.offendingBytes, options.saveDirectory);
+			}
+		}
+
+		fits.push_back(fit);
+	}
+
+	return fits;
+}
+
+std::string daedalus::complexity::repr(const std::string& target, const daedalus::complexity::Sample& sample) {
+	char buffer[256];
+	std::snprintf(
+		buffer,
+		sizeof(buffer),
+		"%-16s %10zu B  lex %10.3f ms %9zu allocs  parse %10.3f ms %9zu allocs  interpret %10.3f ms %9zu allocs",
+		target.c_str(),
+		sample.bytes,
+		sample.seconds[0] * 1e3,
+		sample.allocations[0],
+		sample.seconds[1] * 1e3,
+		sample.allocations[1],
+		sample.seconds[2] * 1e3,
+		sample.allocations[2]
+	);
+	return buffer;
+}
+
+std::string daedalus::complexity::repr(const daedalus::complexity::Fit& fit) {
+	char buffer[512];
+	std::snprintf(
+		buffer,
+		sizeof(buffer),
+		"%-16s %-10s time exponent %6.2f  allocation exponent %6.2f%s",
+		fit.target.c_str(),
+		fit.stage.c_str(),
+		fit.timeExponent,
+		fit.allocationExponent,
+		fit.superLinear ? "  SUPER-LINEAR" : ""
+	);
+
+	std::string representation = buffer;
+	if(fit.superLinear) {
+		representation += " from " + std::to_string(fit.offendingBytes) + " B";
+		if(!fit.savedPath.empty()) {
+			representation += ", saved to " + fit.savedPath;
+		}
+	}
+	return representation;
+}
@@ -0,0 +1,132 @@
+#ifndef __DAEDALUS_COMPLEXITY__
+#define __DAEDALUS_COMPLEXITY__
+
+#include "../daedalus-bench/grammars.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Number of pipeline stages the harness measures (lex, parse with constant folding, interpret)
+ */
+#define DAE_COMPLEXITY_STAGE_COUNT 3
+
+namespace daedalus {
+	namespace complexity {
+
+		/**
+		 * A generator of inputs of growing size
+		 */
+		typedef struct Target {
+			daedalus::bench::Grammar grammar;
+			/**
+			 * Largest input to generate (`0` for no limit other than the options)
+			 * @note Deeply nested inputs are recursed into by every stage, they are capped to stay within the stack
+			 */
+			size_t maxBytes;
+		} Target;
+
+		typedef struct Options {
+			/**
+			 * Only run the targets whose name is listed (all of them when empty)
+			 */
+			std::vector<std::string> targets;
+			size_t minBytes = 256;
+			size_t maxBytes = 1 << 20;
+			/**
+			 * Factor between two consecutive input sizes
+			 */
+			size_t growth = 2;
+			/**
+			 * Stop growing an input once a single run takes longer than this
+			 */
+			double timeLimit = 1;
+			/**
+			 * Minimum time to spend running each input, the fastest run being kept
+			 */
+			double minSeconds = 0.05;
+			/**
+			 * Exponent above which the growth of a stage fails the harness, for time and allocations
+			 */
+			double maxExponent = 1.3;
+			/**
+			 * Directory the smallest offending inputs are saved to (not saved when empty)
+			 */
+			std::string saveDirectory = "complexity-regressions";
+		} Options;
+
+		/**
+		 * The cost of every stage for an input size
+		 */
+		typedef struct Sample {
+			size_t bytes;
+			/**
+			 * Fastest time of each stage over the runs
+			 */
+			double seconds[DAE_COMPLEXITY_STAGE_COUNT];
+			/**
+			 * Heap allocations done by each stage
+			 */
+			size_t allocations[DAE_COMPLEXITY_STAGE_COUNT];
+		} Sample;
+
+		/**
+		 * The growth of a stage of a target, fitted over every sample
+		 */
+		typedef struct Fit {
+			std::string target;
+			std::string stage;
+			/**
+			 * `k` such that the time of the stage grows as `bytes^k` (least squares in log-log space)
+			 * @note `0` when fewer than 3 samples ran long enough to be measured reliably
+			 */
+			double timeExponent;
+			double allocationExponent;
+			bool superLinear;
+			/**
+			 * Size of the smallest input showing the growth (`0` when not super-linear)
+			 */
+			size_t offendingBytes;
+			/**
+			 * File the offending input was saved to (empty when not saved)
+			 */
+			std::string savedPath;
+		} Fit;
+
+		/**
+		 * Get the inputs known to have triggered super-linear stages: long comments, long statements, deep nesting,
+		 * and the reference grammars of the benchmarks
+		 */
+		std::vector<Target> default_targets();
+
+		/**
+		 * Grow the inputs of a target and measure every stage
+		 * @param target The target to run
+		 * @param options The size and time settings
+		 * @return The samples, in increasing size order
+		 */
+		std::vector<Sample> sample_target(const Target& target, const Options& options);
+
+		/**
+		 * Fit the growth of every stage of a target, saving the smallest offending input of super-linear stages
+		 * @param target The target the samples were taken from
+		 * @param samples The samples, in increasing size order
+		 * @param options The bound and save settings
+		 * @return One fit per stage
+		 */
+		std::vector<Fit> fit_target(const Target& target, const std::vector<Sample>& samples, const Options& options);
+
+		/**
+		 * Get the string representation of a sample
+		 */
+		std::string repr(const std::string& target, const Sample& sample);
+
+		/**
+		 * Get the string representation of a fit
+		 */
+		std::string repr(const Fit& fit);
+	}
+}
+
+#endif // __DAEDALUS_COMPLEXITY__
@@ -0,0 +1,92 @@
+#include "complexity.hpp"
+
+#include <daedalus/core/core.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+// Every heap allocation of the pipeline is counted, not only the value pools
+DAE_TRACK_GLOBAL_ALLOCATIONS
+
+namespace {
+	void print_usage() {
+		std::cout <<
+			"Usage: daedalus-complexity [options]\n"
+			"  --target <name>         Only run a target, can be repeated\n"
+			"  --min-bytes <n>         Smallest generated input (default 256)\n"
+			"  --max-bytes <n>         Largest generated input (default 1048576)\n"
+			"  --time-limit <seconds>  Stop growing an input once a run takes longer (default 1)\n"
+			"  --max-exponent <k>      Fail when a stage grows faster than bytes^k (default 1.3)\n"
+			"  --save-dir <dir>        Save the smallest offending inputs there (default complexity-regressions, empty to disable)\n"
+			"  --list                  Print the target names\n";
+	}
+
+	bool should_run(const daedalus::complexity::Options& options, const std::string& target) {
+		return options.targets.empty() || std::find(options.targets.begin(), options.targets.end(), target) != options.targets.end();
+	}
+}
+
+int main(int argc, char** argv) {
+	daedalus::complexity::Options options;
+	std::vector<daedalus::complexity::Target> targets = daedalus::complexity::default_targets();
+
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if(arg == "--target" && hasValue) {
+			options.targets.push_back(argv[++i]);
+		} else if(arg == "--min-bytes" && hasValue) {
+			options.minBytes = std::strtoull(argv[++i], nullptr, 10);
+		} else if(arg == "--max-bytes" && hasValue) {
+			options.maxBytes = std::strtoull(argv[++i], nullptr, 10);
+		} else if(arg == "--time-limit" && hasValue) {
+			options.timeLimit = std::strtod(argv[++i], nullptr);
+		} else if(arg == "--max-exponent" && hasValue) {
+			options.maxExponent = std::strtod(argv[++i], nullptr);
+		} else if(arg == "--save-dir" && hasValue) {
+			options.saveDirectory = argv[++i];
+		} else if(arg == "--list") {
+			for(const daedalus::complexity::Target& target : targets) {
+				std::cout << target.grammar.name << std::endl;
+			}
+			return 0;
+		} else {
+			print_usage();
+			return arg == "--help" ? 0 : 2;
+		}
+	}
+
+	std::vector<daedalus::complexity::Fit> fits;
+	bool failed = false;
+
+	for(const daedalus::complexity::Target& target : targets) {
+		if(!should_run(options, target.grammar.name)) {
+			continue;
+		}
+
+		try {
+			std::vector<daedalus::complexity::Sample> samples = daedalus::complexity::sample_target(target, options);
+			for(const daedalus::complexity::Sample& sample : samples) {
+				std::cout << daedalus::complexity::repr(target.grammar.name, sample) << std::endl;
+			}
+
+			std::vector<daedalus::complexity::Fit> targetFits = daedalus::complexity::fit_target(target, samples, options);
+			fits.insert(fits.end(), targetFits.begin(), targetFits.end());
+		} catch(const std::exception& e) {
+			std::cerr << target.grammar.name << ": " << e.what() << std::endl;
+			failed = true;
+		}
+	}
+
+	std::cout << std::endl;
+	for(const daedalus::complexity::Fit& fit : fits) {
+		std::cout << daedalus::complexity::repr(fit) << std::endl;
+		failed = failed || fit.superLinear;
+	}
+
+	return failed ? 1 : 0;
+}
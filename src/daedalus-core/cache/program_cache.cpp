@@ -0,0 +1,225 @@
+#include <daedalus/core/cache/program_cache.hpp>
+
+#include <algorithm>
+
+namespace {
+	const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+	const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	/**
+	 * FNV-1a over a byte range
+	 */
+	uint64_t hash_bytes(uint64_t hash, const void* data, size_t length) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for(size_t i = 0; i < length; i++) {
+			hash = (hash ^ bytes[i]) * FNV_PRIME;
+		}
+		return hash;
+	}
+
+	/**
+	 * Hash a string with its length, so consecutive strings cannot be confused
+	 */
+	uint64_t hash_string(uint64_t hash, const std::string& str) {
+		size_t length = str.length();
+		hash = hash_bytes(hash, &length, sizeof(length));
+		return hash_bytes(hash, str.data(), str.length());
+	}
+
+	uint64_t hash_char(uint64_t hash, char c) {
+		return hash_bytes(hash, &c, 1);
+	}
+}
+
+uint64_t daedalus::core::cache::fingerprint(const daedalus::core::Daedalus& daedalus, const std::string& salt) {
+	uint64_t hash = hash_string(FNV_OFFSET, salt);
+
+	// * Lexer
+
+	const daedalus::core::lexer::Lexer& lexer = daedalus.lexer;
+	for(const daedalus::core::lexer::TokenType& tokenType : lexer.tokenTypes) {
+		hash = hash_string(hash, tokenType.name);
+		hash = hash_char(hash, tokenType.lex_typed_token != nullptr);
+	}
+	hash = hash_string(hash, std::string(lexer.whitespaces.begin(), lexer.whitespaces.end()));
+	hash = hash_string(hash, lexer.singleLineComment);
+	hash = hash_string(hash, lexer.multiLineComment.first);
+	hash = hash_string(hash, lexer.multiLineComment.second);
+	hash = hash_char(hash, lexer.decimalSeparator);
+	hash = hash_char(hash, lexer.charDelimiter);
+	hash = hash_char(hash, lexer.stringDelimiter);
+	hash = hash_char(hash, lexer.escapeCharacter);
+	// Static token sets are types, their matcher is the same for the whole process
+	hash = hash_bytes(hash, &lexer.staticMatcher, sizeof(lexer.staticMatcher));
+
+	// * Parser, the node register being unordered
+
+	std::vector<std::string> nodes;
+	for(const auto& [key, node] : daedalus.parser.nodesRegister) {
+		nodes.push_back(key + (node.isTopNode ? "+" : "-"));
+	}
+	std::sort(nodes.begin(), nodes.end());
+	for(const std::string& node : nodes) {
+		hash = hash_string(hash, node);
+	}
+	for(daedalus::core::parser::ParserFlags flag : daedalus.parser.flags) {
+		hash = hash_char(hash, static_cast<char>(flag));
+	}
+	hash = hash_char(hash, daedalus.parser.decimalSeparator);
+
+	return hash;
+}
+
+uint64_t daedalus::core::cache::hash_source(const std::string& src) {
+	return hash_bytes(FNV_OFFSET, src.data(), src.length());
+}
+
+daedalus::core::cache::ProgramCache::ProgramCache(daedalus::core::cache::ProgramCacheOptions options) :
+	options(options),
+	compilations(0),
+	stats(daedalus::core::cache::ProgramCacheStats{ 0, 0, 0, 0, 0 })
+{}
+
+std::shared_ptr<const daedalus::core::ast::Scope> daedalus::core::cache::ProgramCache::get_or_compile(
+	daedalus::core::Daedalus& daedalus,
+	const std::string& src,
+	uint64_t fingerprint
+) {
+	uint64_t key = daedalus::core::cache::hash_source(src) ^ (fingerprint * FNV_PRIME);
+	std::promise<std::shared_ptr<const daedalus::core::ast::Scope>> promise;
+	ProgramFuture cached;
+	bool cacheable = true;
+	uint64_t compilation = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		auto entry = this->entries.find(key);
+		if(entry != this->entries.end()) {
+			if(entry->second.fingerprint == fingerprint && entry->second.source == src) {
+				this->stats.hits++;
+				this->recentUses.splice(this->recentUses.begin(), this->recentUses, entry->second.recentUse);
+				cached = entry->second.program;
+			} else {
+				// Hash collision, the program is compiled without replacing the cached one
+				cacheable = false;
+			}
+		}
+
+		if(!cached.valid()) {
+			this->stats.misses++;
+			if(cacheable) {
+				compilation = ++this->compilations;
+				this->recentUses.push_front(key);
+				this->entries.emplace(key, Entry{
+					src,
+					fingerprint,
+					promise.get_future().share(),
+					0,
+					compilation,
+					this->recentUses.begin()
+				});
+			}
+		}
+	}
+
+	// Waits for the program if another thread is compiling it
+	if(cached.valid()) {
+		return cached.get();
+	}
+
+	std::shared_ptr<daedalus::core::ast::Scope> program = std::make_shared<daedalus::core::ast::Scope>();
+	try {
+		std::vector<daedalus::core::lexer::Token> tokens;
+		daedalus::core::lexer::lex(daedalus.lexer, tokens, src);
+		daedalus::core::parser::parse(daedalus.parser, program, tokens);
+	} catch(...) {
+		if(cacheable) {
+			std::lock_guard<std::mutex> lock(this->mutex);
+			auto entry = this->entries.find(key);
+			if(entry != this->entries.end() && entry->second.compilation == compilation) {
+				this->recentUses.erase(entry->second.recentUse);
+				this->entries.erase(entry);
+			}
+			promise.set_exception(std::current_exception());
+		}
+		throw;
+	}
+
+	if(!cacheable) {
+		return program;
+	}
+
+	size_t nodeCount = 0;
+	size_t astBytes = 0;
+	daedalus::core::measure_ast(program, nodeCount, astBytes);
+
+	promise.set_value(program);
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	auto entry = this->entries.find(key);
+	// The entry can have been cleared while compiling, and replaced by another thread's
+	if(entry != this->entries.end() && entry->second.compilation == compilation) {
+		entry->second.bytes = src.capacity() + astBytes;
+		this->stats.bytes += entry->second.bytes;
+		this->evict();
+	}
+
+	return program;
+}
+
+std::shared_ptr<const daedalus::core::ast::Scope> daedalus::core::cache::ProgramCache::get_or_compile(
+	daedalus::core::Daedalus& daedalus,
+	const std::string& src
+) {
+	return this->get_or_compile(daedalus, src, daedalus::core::cache::fingerprint(daedalus));
+}
+
+daedalus::core::cache::ProgramCacheStats daedalus::core::cache::ProgramCache::get_stats() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	daedalus::core::cache::ProgramCacheStats stats = this->stats;
+	stats.entries = this->entries.size();
+	return stats;
+}
+
+void daedalus::core::cache::ProgramCache::clear() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->entries.clear();
+	this->recentUses.clear();
+	this->stats.bytes = 0;
+}
+
+void daedalus::core::cache::ProgramCache::evict() {
+	auto recentUse = this->recentUses.end();
+	while(recentUse != this->recentUses.begin() && (this->entries.size() > this->options.maxEntries || this->stats.bytes > this->options.maxBytes)) {
+		--recentUse;
+
+		auto entry = this->entries.find(*recentUse);
+		if(entry->second.bytes == 0) {
+			continue;
+		}
+
+		this->stats.bytes -= entry->second.bytes;
+		this->stats.evictions++;
+		recentUse = this->recentUses.erase(recentUse);
+		this->entries.erase(entry);
+	}
+}
+
+void daedalus::core::cache::run_cached(
+	daedalus::core::Daedalus& daedalus,
+	daedalus::core::cache::ProgramCache& cache,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	const std::string& src,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	std::shared_ptr<const daedalus::core::ast::Scope> program = cache.get_or_compile(daedalus, src);
+
+	// Evaluation functions only read the nodes, the program stays shared
+	daedalus::core::interpreter::interpret(
+		daedalus.interpreter,
+		results,
+		std::const_pointer_cast<daedalus::core::ast::Scope>(program),
+		env
+	);
+}
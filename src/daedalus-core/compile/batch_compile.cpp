@@ -0,0 +1,155 @@
+#include <daedalus/core/compile/batch_compile.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+	double seconds_since(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	bool read_file(const std::string& path, std::string& content) {
+		std::ifstream file(path, std::ios::binary);
+		if(!file) {
+			return false;
+		}
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return !file.bad();
+	}
+
+	void fail(
+		daedalus::core::compile::CompiledSource& compiled,
+		const daedalus::core::tools::Error& error,
+		const std::string& src
+	) {
+		compiled.error = error;
+		compiled.message = daedalus::core::tools::format_error(error, src);
+	}
+
+	void compile_source(
+		daedalus::core::Daedalus& daedalus,
+		const daedalus::core::compile::SourceInput& input,
+		daedalus::core::compile::CompiledSource& compiled
+	) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		compiled.name = input.name;
+
+		std::string content;
+		if(input.isPath && !read_file(input.name, content)) {
+			fail(compiled, daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::READ_ERROR, 0, "Cannot read source file " + input.name }, "");
+			compiled.seconds = seconds_since(start);
+			return;
+		}
+		const std::string& src = input.isPath ? content : input.source;
+		compiled.bytes = src.length();
+
+		std::vector<daedalus::core::lexer::Token> tokens;
+		daedalus::core::tools::Result<void> lexed = daedalus::core::tools::Result<void>();
+		{
+			daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::LEXER);
+			lexed = daedalus::core::lexer::try_lex(daedalus.lexer, tokens, src);
+		}
+		if(!lexed) {
+			fail(compiled, lexed.error(), src);
+			compiled.seconds = seconds_since(start);
+			return;
+		}
+		compiled.tokenCount = tokens.size();
+
+		auto program = std::make_shared<daedalus::core::ast::Scope>();
+		daedalus::core::tools::Result<void> parsed = daedalus::core::tools::Result<void>();
+		{
+			daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::PARSER);
+			parsed = daedalus::core::parser::try_parse(daedalus.parser, program, tokens);
+		}
+		if(!parsed) {
+			fail(compiled, parsed.error(), src);
+		} else {
+			compiled.program = program;
+		}
+		compiled.seconds = seconds_since(start);
+	}
+}
+
+daedalus::core::compile::SourceInput daedalus::core::compile::make_path_input(std::string path) {
+	return daedalus::core::compile::SourceInput{
+		path,
+		"",
+		true
+	};
+}
+
+daedalus::core::compile::SourceInput daedalus::core::compile::make_buffer_input(std::string name, std::string source) {
+	return daedalus::core::compile::SourceInput{
+		name,
+		source,
+		false
+	};
+}
+
+daedalus::core::compile::BatchCompilation daedalus::core::compile::compile_batch(
+	daedalus::core::Daedalus& daedalus,
+	const std::vector<daedalus::core::compile::SourceInput>& inputs,
+	daedalus::core::tools::ThreadPool& pool
+) {
+	daedalus::core::compile::BatchCompilation compilation;
+	compilation.sources.resize(inputs.size(), daedalus::core::compile::CompiledSource{ "", nullptr, std::nullopt, "", 0, 0, 0 });
+
+	daedalus::core::tools::ThreadPoolStats poolStats = pool.get_stats();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Each task only writes its own entry
+	for(size_t i = 0; i < inputs.size(); i++) {
+		pool.submit([&daedalus, &inputs, &compilation, i] () {
+			compile_source(daedalus, inputs[i], compilation.sources[i]);
+		});
+	}
+	pool.wait();
+
+	daedalus::core::compile::BatchCompileStats& stats = compilation.stats;
+	stats = daedalus::core::compile::BatchCompileStats{ inputs.size(), 0, 0, 0, seconds_since(start), 0, 0, 0, pool.get_thread_count(), 0 };
+	for(const daedalus::core::compile::CompiledSource& compiled : compilation.sources) {
+		stats.failures += compiled.error.has_value();
+		stats.bytes += compiled.bytes;
+		stats.tokens += compiled.tokenCount;
+		stats.busySeconds += compiled.seconds;
+	}
+	if(stats.seconds > 0) {
+		stats.sourcesPerSecond = stats.sources / stats.seconds;
+		stats.bytesPerSecond = stats.bytes / stats.seconds;
+	}
+	stats.steals = pool.get_stats().stolen - poolStats.stolen;
+
+	return compilation;
+}
+
+daedalus::core::compile::BatchCompilation daedalus::core::compile::compile_batch(
+	daedalus::core::Daedalus& daedalus,
+	const std::vector<daedalus::core::compile::SourceInput>& inputs,
+	size_t threadCount
+) {
+	daedalus::core::tools::ThreadPool pool(threadCount);
+	return daedalus::core::compile::compile_batch(daedalus, inputs, pool);
+}
+
+std::string daedalus::core::compile::repr(const daedalus::core::compile::BatchCompileStats& stats) {
+	char throughput[128];
+	std::snprintf(
+		throughput,
+		sizeof(throughput),
+		"%.3fs (%.1f sources/s, %.2f MB/s, %.2fx parallelism)",
+		stats.seconds,
+		stats.sourcesPerSecond,
+		stats.bytesPerSecond / (1024 * 1024),
+		stats.seconds > 0 ? stats.busySeconds / stats.seconds : 0
+	);
+
+	std::ostringstream out;
+	out << stats.sources << " sources (" << stats.failures << " failed), "
+		<< stats.bytes << " bytes, " << stats.tokens << " tokens in " << throughput
+		<< " on " << stats.threadCount << " threads, " << stats.steals << " stolen";
+	return out.str();
+}
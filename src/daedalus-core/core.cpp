@@ -1,5 +1,15 @@
 #include <daedalus/core/core.hpp>
 
+#include <daedalus/core/tools/spsc_queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
 daedalus::core::Daedalus daedalus::core::setup_daedalus(
 	daedalus::core::LexerConfigFunction lexerConfigFunction,
 	daedalus::core::ParserConfigFunction parserConfigFunction,
@@ -13,5 +23,387 @@ daedalus::core::Daedalus daedalus::core::setup_daedalus(
 	parserConfigFunction(parser);
 	interpreterConfigFunction(interpreter);
 
+	// Numbers lexed without payload are read with the separator they were lexed with
+	parser.decimalSeparator = lexer.decimalSeparator;
+
+	// Created before the parser is copied, so its copies share the pool
+	if(daedalus::core::parser::has_flag(parser, daedalus::core::parser::ParserFlags::INTERN_NODES)) {
+		daedalus::core::parser::get_node_pool(parser);
+	}
+
 	return daedalus::core::Daedalus{ lexer, parser, interpreter };
 }
+
+namespace {
+	double seconds_since(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	size_t string_heap_bytes(const std::string& str) {
+		const char* object = reinterpret_cast<const char*>(&str);
+		bool isInline = str.data() >= object && str.data() < object + sizeof(std::string);
+		return isInline ? 0 : str.capacity() + 1;
+	}
+
+	void end_phase(daedalus::core::tools::AllocationTracker* tracker, daedalus::core::tools::PipelinePhase phase) {
+		if(tracker != nullptr) {
+			tracker->end_phase(phase);
+		}
+	}
+
+	/**
+	 * Stop the tracker when the run ends, even on errors
+	 */
+	typedef struct TrackerStop {
+		daedalus::core::tools::AllocationTracker* tracker;
+
+		~TrackerStop() {
+			if(this->tracker != nullptr) {
+				this->tracker->stop();
+			}
+		}
+	} TrackerStop;
+
+	/**
+	 * Thrown inside a stage to stop it once another stage failed
+	 */
+	typedef struct StageStopped {} StageStopped;
+
+	/**
+	 * The state shared by the stages of a streaming run
+	 */
+	typedef struct StreamingState {
+		/**
+		 * Set when a stage failed or the run ended early, the other stages stopping on their next wait
+		 */
+		std::atomic<bool> stopped = false;
+		std::exception_ptr error = nullptr;
+		std::mutex errorMutex;
+
+		void fail(std::exception_ptr exception) {
+			std::lock_guard<std::mutex> lock(this->errorMutex);
+			if(this->error == nullptr) {
+				this->error = exception;
+			}
+			this->stopped = true;
+		}
+	} StreamingState;
+
+	/**
+	 * Waits between the attempts of a stage on a full or empty queue, yielding first and then sleeping longer and longer
+	 */
+	class Backoff {
+	public:
+		void wait() {
+			if(this->attempts < BACKOFF_YIELDS) {
+				this->attempts++;
+				std::this_thread::yield();
+				return;
+			}
+			std::this_thread::sleep_for(this->sleep);
+			this->sleep = std::min(this->sleep * 2, BACKOFF_MAX_SLEEP);
+		}
+
+	private:
+		static constexpr size_t BACKOFF_YIELDS = 64;
+		static constexpr std::chrono::microseconds BACKOFF_MAX_SLEEP = std::chrono::microseconds(500);
+
+		size_t attempts = 0;
+		std::chrono::microseconds sleep = std::chrono::microseconds(1);
+	};
+
+	/**
+	 * Join a stage thread when leaving the run, stopping the other stages first if the run did not join it
+	 */
+	typedef struct StageJoin {
+		std::thread& thread;
+		StreamingState& state;
+
+		~StageJoin() {
+			if(this->thread.joinable()) {
+				this->state.stopped = true;
+				this->thread.join();
+			}
+		}
+	} StageJoin;
+
+	template<typename T, typename U>
+	void push_blocking(daedalus::core::tools::SpscQueue<T>& queue, U&& value, StreamingState& state) {
+		Backoff backoff;
+		while(!queue.try_push(std::forward<U>(value))) {
+			if(state.stopped) {
+				throw StageStopped();
+			}
+			backoff.wait();
+		}
+	}
+
+	template<typename T>
+	T pop_blocking(daedalus::core::tools::SpscQueue<T>& queue, StreamingState& state) {
+		T value;
+		Backoff backoff;
+		while(!queue.try_pop(value)) {
+			if(state.stopped) {
+				throw StageStopped();
+			}
+			backoff.wait();
+		}
+		return value;
+	}
+}
+
+daedalus::core::PipelineMetrics daedalus::core::run(
+	daedalus::core::Daedalus& daedalus,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	std::string src
+) {
+	daedalus::core::PipelineMetrics metrics = daedalus::core::PipelineMetrics{ 0, 0, 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+	daedalus::core::tools::AllocationTracker* tracker = daedalus.allocationTracker.get();
+	if(tracker != nullptr) {
+		tracker->start();
+	}
+	TrackerStop trackerStop = TrackerStop{ tracker };
+
+	// * Lex
+
+	std::vector<daedalus::core::lexer::Token> tokens;
+	auto start = std::chrono::steady_clock::now();
+	{
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::LEXER);
+		daedalus::core::lexer::lex(daedalus.lexer, tokens, src);
+	}
+	metrics.lexSeconds = seconds_since(start);
+	end_phase(tracker, daedalus::core::tools::PipelinePhase::LEXER);
+
+	metrics.tokenCount = tokens.size();
+	metrics.tokenBytes = tokens.capacity() * sizeof(daedalus::core::lexer::Token);
+	for(const daedalus::core::lexer::Token& token : tokens) {
+		metrics.tokenBytes += string_heap_bytes(token.type) + string_heap_bytes(token.value);
+	}
+
+	// * Parse, the constant folding being timed separately
+
+	// The shared configuration is left untouched, concurrent runs and lazy scopes reading it
+	bool optimize = daedalus::core::parser::has_flag(daedalus.parser, daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR);
+	if(daedalus::core::parser::has_flag(daedalus.parser, daedalus::core::parser::ParserFlags::INTERN_NODES)) {
+		daedalus::core::parser::get_node_pool(daedalus.parser);
+	}
+	daedalus::core::parser::Parser parser = daedalus.parser;
+	parser.flags.erase(
+		std::remove(parser.flags.begin(), parser.flags.end(), daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR),
+		parser.flags.end()
+	);
+
+	start = std::chrono::steady_clock::now();
+	auto program = std::make_shared<daedalus::core::ast::Scope>();
+	{
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::PARSER);
+		daedalus::core::parser::parse(parser, program, tokens);
+	}
+	metrics.parseSeconds = seconds_since(start);
+	end_phase(tracker, daedalus::core::tools::PipelinePhase::PARSER);
+
+	if(optimize) {
+		start = std::chrono::steady_clock::now();
+		{
+			daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::OPTIMIZER);
+			program->get_constexpr();
+
+			// Folded statements are new nodes, they are interned once folded
+			if(daedalus::core::parser::has_flag(daedalus.parser, daedalus::core::parser::ParserFlags::INTERN_NODES)) {
+				std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body = program->get_body();
+				for(std::shared_ptr<daedalus::core::ast::Expression>& expression : body) {
+					expression = daedalus::core::parser::intern_node(daedalus.parser, expression);
+				}
+				program = std::make_shared<daedalus::core::ast::Scope>(body);
+			}
+		}
+		metrics.optimizeSeconds = seconds_since(start);
+		end_phase(tracker, daedalus::core::tools::PipelinePhase::OPTIMIZER);
+	}
+
+	daedalus::core::measure_ast(program, metrics.nodeCount, metrics.astBytes);
+
+	// * Interpret
+
+	daedalus::core::env::EnvStats envStats = daedalus::core::env::get_env_stats();
+	start = std::chrono::steady_clock::now();
+	{
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::INTERPRETER);
+		daedalus::core::interpreter::interpret(daedalus.interpreter, results, program);
+	}
+	metrics.interpretSeconds = seconds_since(start);
+	end_phase(tracker, daedalus::core::tools::PipelinePhase::INTERPRETER);
+
+	daedalus::core::env::EnvStats endEnvStats = daedalus::core::env::get_env_stats();
+	metrics.envStats = daedalus::core::env::EnvStats{
+		endEnvStats.gets - envStats.gets,
+		endEnvStats.sets - envStats.sets,
+		endEnvStats.inits - envStats.inits
+	};
+
+	if(daedalus.metricsSink != nullptr) {
+		daedalus.metricsSink(metrics);
+	}
+
+	return metrics;
+}
+
+void daedalus::core::run_streaming(
+	daedalus::core::Daedalus& daedalus,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	std::string src,
+	daedalus::core::StreamingOptions options,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	StreamingState state;
+	daedalus::core::tools::SpscQueue<daedalus::core::lexer::Token> tokens(options.tokenQueueCapacity);
+	// A `nullptr` statement marks the end of the program
+	daedalus::core::tools::SpscQueue<std::shared_ptr<daedalus::core::ast::Expression>> statements(options.statementQueueCapacity);
+
+	// * Lex
+
+	std::thread lexerThread;
+	std::thread parserThread;
+	// Declared after the threads so they are joined before the queues and the state are destroyed
+	StageJoin lexerJoin = StageJoin{ lexerThread, state };
+	StageJoin parserJoin = StageJoin{ parserThread, state };
+
+	lexerThread = std::thread([&] () {
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::LEXER);
+		try {
+			daedalus::core::lexer::lex_stream(
+				daedalus.lexer,
+				[&] (daedalus::core::lexer::Token token) {
+					push_blocking(tokens, std::move(token), state);
+				},
+				std::move(src)
+			);
+		} catch(const StageStopped&) {
+		} catch(...) {
+			state.fail(std::current_exception());
+		}
+	});
+
+	// * Parse, one top-level statement at a time
+
+	parserThread = std::thread([&] () {
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::PARSER);
+		try {
+			std::vector<daedalus::core::lexer::Token> chunk;
+			size_t depth = 0;
+
+			for(;;) {
+				daedalus::core::lexer::Token token = pop_blocking(tokens, state);
+				bool end = token.type == "EOF";
+
+				if(!end) {
+					for(const auto& [opener, closer] : options.brackets) {
+						if(token.type == opener) {
+							depth++;
+						} else if(token.type == closer && depth > 0) {
+							depth--;
+						}
+					}
+				}
+
+				bool terminated = depth == 0 && std::find(options.terminators.begin(), options.terminators.end(), token.type) != options.terminators.end();
+				if(!end) {
+					chunk.push_back(std::move(token));
+				}
+
+				if(terminated || end) {
+					chunk.push_back(daedalus::core::lexer::Token{ "EOF", "" });
+					while(peek(chunk).type != "EOF") {
+						push_blocking(statements, daedalus::core::parser::parse_expression(daedalus.parser, chunk, true), state);
+					}
+					chunk.clear();
+				}
+
+				if(end) {
+					break;
+				}
+			}
+		} catch(const StageStopped&) {
+		} catch(...) {
+			state.fail(std::current_exception());
+		}
+
+		// Wake the interpreter up, a stopped run being noticed by the interpreter on its next statement
+		try {
+			push_blocking(statements, nullptr, state);
+		} catch(const StageStopped&) {
+		}
+	});
+
+	// * Interpret on the calling thread
+
+	try {
+		daedalus::core::tools::PipelinePhaseScope phase(daedalus::core::tools::PipelinePhase::INTERPRETER);
+
+		if(env == nullptr) {
+			env = daedalus::core::env::make_environment(
+				daedalus.interpreter.envValuesProperties,
+				daedalus.interpreter.validationRules
+			);
+		}
+		if(DAE_PROFILING(daedalus.interpreter.profiler) && env->get_profiler() == nullptr) {
+			env->set_profiler(daedalus.interpreter.profiler);
+		}
+
+		for(;;) {
+			std::shared_ptr<daedalus::core::ast::Expression> statement = pop_blocking(statements, state);
+			if(statement == nullptr || state.stopped) {
+				break;
+			}
+
+			daedalus::core::interpreter::RuntimeValueWrapper result = daedalus::core::interpreter::evaluate_statement(daedalus.interpreter, statement, env);
+			if(daedalus::core::interpreter::flag_contains(result.flags, options.escapeFlag)) {
+				state.stopped = true;
+				break;
+			}
+			results.push_back(daedalus::core::interpreter::RuntimeResult{
+				statement->repr(),
+				result.value->repr()
+			});
+			if(options.onResult != nullptr) {
+				options.onResult(results.back());
+			}
+		}
+	} catch(const StageStopped&) {
+	} catch(...) {
+		state.fail(std::current_exception());
+	}
+
+	lexerThread.join();
+	parserThread.join();
+
+	if(state.error != nullptr) {
+		std::rethrow_exception(state.error);
+	}
+}
+
+void daedalus::core::measure_ast(
+	std::shared_ptr<daedalus::core::ast::Statement> root,
+	size_t& nodeCount,
+	size_t& astBytes
+) {
+	std::vector<std::shared_ptr<daedalus::core::ast::Statement>> pending = { root };
+	// Interned subtrees are shared, each node is only counted once
+	std::unordered_set<daedalus::core::ast::Statement*> visited;
+
+	while(!pending.empty()) {
+		std::shared_ptr<daedalus::core::ast::Statement> node = pending.back();
+		pending.pop_back();
+		if(node == nullptr || !visited.insert(node.get()).second) {
+			continue;
+		}
+
+		nodeCount++;
+		astBytes += node->get_footprint();
+
+		for(const std::shared_ptr<daedalus::core::ast::Expression>& child : node->get_children()) {
+			pending.push_back(child);
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <daedalus/core/tools/allocation_tracker.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Size classes are multiples of this granularity
+ */
+#define DAE_POOL_GRANULARITY 16
+
+/**
+ * Blocks kept per size class before giving them back to the heap
+ */
+#define DAE_POOL_MAX_FREE_BLOCKS 4096
+
+namespace {
+	typedef struct FreeBlock {
+		FreeBlock* next;
+	} FreeBlock;
+
+	typedef struct FreeList {
+		FreeBlock* head = nullptr;
+		size_t length = 0;
+	} FreeList;
+
+	/**
+	 * Set once the calling thread's pools are destroyed, blocks freed afterwards go straight to the heap
+	 */
+	thread_local bool poolsDestroyed = false;
+
+	typedef struct ThreadPools {
+		FreeList lists[DAE_POOL_MAX_BLOCK_SIZE / DAE_POOL_GRANULARITY];
+		daedalus::core::values::AllocationStats stats = { 0, 0, 0, 0 };
+
+		~ThreadPools() {
+			daedalus::core::tools::UntrackedScope untracked;
+			for(FreeList& list : this->lists) {
+				while(list.head != nullptr) {
+					FreeBlock* next = list.head->next;
+					::operator delete(list.head);
+					list.head = next;
+				}
+			}
+			poolsDestroyed = true;
+		}
+	} ThreadPools;
+
+	ThreadPools& thread_pools() {
+		thread_local ThreadPools pools;
+		return pools;
+	}
+
+	size_t size_class(size_t size) {
+		return (size + DAE_POOL_GRANULARITY - 1) / DAE_POOL_GRANULARITY - 1;
+	}
+
+	std::shared_ptr<daedalus::core::values::Region>& installed_region() {
+		thread_local std::shared_ptr<daedalus::core::values::Region> region = nullptr;
+		return region;
+	}
+
+	char* align_up(char* pointer, size_t alignment) {
+		uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+		return pointer + ((alignment - address % alignment) % alignment);
+	}
+}
+
+daedalus::core::values::AllocationStats daedalus::core::values::get_allocation_stats() {
+	return thread_pools().stats;
+}
+
+void daedalus::core::values::reset_allocation_stats() {
+	thread_pools().stats = daedalus::core::values::AllocationStats{ 0, 0, 0, 0 };
+}
+
+void* daedalus::core::values::pool_allocate(size_t size) {
+	// The hooks see the requested size, the heap blocks backing the pools are not tracked twice
+	daedalus::core::tools::notify_allocation(size);
+	daedalus::core::tools::UntrackedScope untracked;
+
+	if(poolsDestroyed) {
+		return ::operator new(size);
+	}
+
+	ThreadPools& pools = thread_pools();
+	pools.stats.bytes += size;
+
+	if(size == 0 || size > DAE_POOL_MAX_BLOCK_SIZE) {
+		pools.stats.heapAllocations++;
+		return ::operator new(size);
+	}
+
+	size_t index = size_class(size);
+	FreeList& list = pools.lists[index];
+
+	if(list.head != nullptr) {
+		FreeBlock* block = list.head;
+		list.head = block->next;
+		list.length--;
+		pools.stats.pooledAllocations++;
+		return block;
+	}
+
+	pools.stats.heapAllocations++;
+	return ::operator new((index + 1) * DAE_POOL_GRANULARITY);
+}
+
+void daedalus::core::values::pool_deallocate(void* block, size_t size) {
+	daedalus::core::tools::notify_deallocation(size);
+	daedalus::core::tools::UntrackedScope untracked;
+
+	if(poolsDestroyed) {
+		::operator delete(block);
+		return;
+	}
+
+	ThreadPools& pools = thread_pools();
+	pools.stats.deallocations++;
+
+	if(size == 0 || size > DAE_POOL_MAX_BLOCK_SIZE) {
+		::operator delete(block);
+		return;
+	}
+
+	FreeList& list = pools.lists[size_class(size)];
+
+	if(list.length >= DAE_POOL_MAX_FREE_BLOCKS) {
+		::operator delete(block);
+		return;
+	}
+
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = list.head;
+	list.head = freeBlock;
+	list.length++;
+}
+
+daedalus::core::values::QuotaExceeded::QuotaExceeded(size_t quota, size_t requested) :
+	std::runtime_error("Region quota of " + std::to_string(quota) + " bytes exceeded (" + std::to_string(requested) + " bytes requested)")
+{}
+
+daedalus::core::values::Region::Region(size_t quota, size_t chunkSize) :
+	chunks(nullptr),
+	cursor(nullptr),
+	end(nullptr),
+	chunkSize(std::max<size_t>(chunkSize, sizeof(Chunk))),
+	stats(daedalus::core::values::RegionStats{ 0, 0, 0, quota })
+{}
+
+daedalus::core::values::Region::~Region() {
+	daedalus::core::tools::UntrackedScope untracked;
+
+	while(this->chunks != nullptr) {
+		Chunk* next = this->chunks->next;
+		::operator delete(this->chunks);
+		this->chunks = next;
+	}
+}
+
+void* daedalus::core::values::Region::allocate(size_t size, size_t alignment) {
+	if(this->stats.quota != 0 && this->stats.bytes + size > this->stats.quota) {
+		throw daedalus::core::values::QuotaExceeded(this->stats.quota, this->stats.bytes + size);
+	}
+
+	char* block = this->cursor == nullptr ? nullptr : align_up(this->cursor, alignment);
+	if(block == nullptr || block + size > this->end) {
+		this->reserve(size, alignment);
+		block = align_up(this->cursor, alignment);
+	}
+
+	// As with the pools, the hooks see the requested blocks and not the chunks backing them
+	daedalus::core::tools::notify_allocation(size);
+
+	this->cursor = block + size;
+	this->stats.allocations++;
+	this->stats.bytes += size;
+	return block;
+}
+
+void daedalus::core::values::Region::deallocate(void* block, size_t size) noexcept {
+	daedalus::core::tools::notify_deallocation(size);
+}
+
+daedalus::core::values::RegionStats daedalus::core::values::Region::get_stats() {
+	return this->stats;
+}
+
+void daedalus::core::values::Region::reserve(size_t size, size_t alignment) {
+	size_t chunkSize = std::max(this->chunkSize, sizeof(Chunk) + size + alignment);
+
+	daedalus::core::tools::UntrackedScope untracked;
+	Chunk* chunk = static_cast<Chunk*>(::operator new(chunkSize));
+	chunk->next = this->chunks;
+	chunk->size = chunkSize;
+
+	this->chunks = chunk;
+	this->cursor = reinterpret_cast<char*>(chunk) + sizeof(Chunk);
+	this->end = reinterpret_cast<char*>(chunk) + chunkSize;
+	this->stats.reservedBytes += chunkSize;
+}
+
+const std::shared_ptr<daedalus::core::values::Region>& daedalus::core::values::current_region() {
+	return installed_region();
+}
+
+daedalus::core::values::RegionScope::RegionScope(std::shared_ptr<daedalus::core::values::Region> region) :
+	previous(std::move(installed_region()))
+{
+	installed_region() = std::move(region);
+}
+
+daedalus::core::values::RegionScope::~RegionScope() {
+	installed_region() = std::move(this->previous);
+}
+
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::values::copy_out(const std::shared_ptr<daedalus::core::values::RuntimeValue>& value) {
+	if(value == nullptr) {
+		return nullptr;
+	}
+	daedalus::core::values::RegionScope suspended(nullptr);
+	return value->copy();
+}
+
+const std::shared_ptr<daedalus::core::values::NullValue>& daedalus::core::values::null_value() {
+	static const std::shared_ptr<daedalus::core::values::NullValue> value = std::make_shared<daedalus::core::values::NullValue>();
+	return value;
+}
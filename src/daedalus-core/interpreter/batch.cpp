@@ -0,0 +1,94 @@
+#include <daedalus/core/interpreter/batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> daedalus::core::interpreter::evaluate_batch(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	const std::vector<daedalus::core::interpreter::InputColumn>& inputs,
+	daedalus::core::interpreter::BatchOptions options
+) {
+	size_t rowCount = inputs.empty() ? 0 : inputs.front().values.size();
+
+	for(const daedalus::core::interpreter::InputColumn& column : inputs) {
+		DAE_ASSERT_TRUE(
+			column.values.size() == rowCount,
+			std::runtime_error("Input column " + column.name + " has " + std::to_string(column.values.size()) + " rows, expected " + std::to_string(rowCount))
+		)
+	}
+
+	std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> outputs(rowCount);
+	if(rowCount == 0) {
+		return outputs;
+	}
+
+	const daedalus::core::interpreter::CompiledScope compiled = daedalus::core::interpreter::compile_scope(interpreter, program);
+
+	size_t blockSize = std::max<size_t>(options.blockSize, 1);
+	size_t blockCount = (rowCount + blockSize - 1) / blockSize;
+	size_t threadCount = options.threadCount != 0 ? options.threadCount : std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	threadCount = std::min(threadCount, blockCount);
+	if(DAE_PROFILING(interpreter.profiler)) {
+		threadCount = 1;
+	}
+
+	std::atomic<size_t> nextBlock = 0;
+	std::atomic<bool> failed = false;
+	std::exception_ptr error = nullptr;
+	std::mutex errorMutex;
+
+	auto worker = [&] () {
+		try {
+			auto env = daedalus::core::env::make_environment(
+				interpreter.envValuesProperties,
+				interpreter.validationRules
+			);
+			env->set_profiler(interpreter.profiler);
+
+			for(size_t block = nextBlock++; block < blockCount && !failed; block = nextBlock++) {
+				size_t end = std::min(rowCount, (block + 1) * blockSize);
+				for(size_t row = block * blockSize; row < end; row++) {
+					env->clear();
+					for(const daedalus::core::interpreter::InputColumn& column : inputs) {
+						env->init_value(column.name, column.values[row], column.properties);
+					}
+					outputs[row] = daedalus::core::interpreter::run_scope(interpreter, compiled, nullptr, env).value;
+				}
+			}
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if(error == nullptr) {
+				error = std::current_exception();
+			}
+			failed = true;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	try {
+		for(size_t i = 1; i < threadCount; i++) {
+			threads.emplace_back(worker);
+		}
+	} catch(...) {
+		// The started workers still reference the locals, they are stopped and joined before leaving
+		failed = true;
+		for(std::thread& thread : threads) {
+			thread.join();
+		}
+		throw;
+	}
+	worker();
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+
+	if(error != nullptr) {
+		std::rethrow_exception(error);
+	}
+
+	return outputs;
+}
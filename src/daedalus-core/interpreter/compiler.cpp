@@ -0,0 +1,149 @@
+#include <daedalus/core/interpreter/compiler.hpp>
+#include <daedalus/core/tools/trace.hpp>
+
+namespace {
+	daedalus::core::interpreter::CompiledStatement compile_node(
+		daedalus::core::interpreter::Interpreter& interpreter,
+		std::shared_ptr<daedalus::core::ast::Statement> statement,
+		const std::string& nodeType
+	) {
+		auto compileFn = interpreter.nodeCompilationFunctions.find(nodeType);
+		if(compileFn != interpreter.nodeCompilationFunctions.end()) {
+			return compileFn->second(interpreter, statement);
+		}
+
+		auto evaluateFn = interpreter.nodeEvaluationFunctions.find(nodeType);
+
+		DAE_ASSERT_TRUE(
+			evaluateFn != interpreter.nodeEvaluationFunctions.end(),
+			std::runtime_error("Trying to compile unknown statement " + nodeType)
+		)
+
+		daedalus::core::interpreter::ParseStatementFunction evaluate = evaluateFn->second;
+
+		return [evaluate, statement] (
+			daedalus::core::interpreter::Interpreter& interpreter,
+			const std::shared_ptr<daedalus::core::env::Environment>& env
+		) -> daedalus::core::interpreter::RuntimeValueWrapper {
+			return evaluate(interpreter, statement, env);
+		};
+	}
+}
+
+daedalus::core::interpreter::CompiledStatement daedalus::core::interpreter::compile_statement(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Statement> statement
+) {
+	std::string nodeType = statement->type();
+
+	daedalus::core::interpreter::CompiledStatement compiled = compile_node(interpreter, statement, nodeType);
+
+	// Always wrapped, tracing being enabled at runtime, compiled programs included, for the cost of a single branch
+#ifndef DAE_NO_TRACE
+	{
+		uint32_t name = daedalus::core::tools::trace_name(nodeType);
+		compiled = [compiled, name] (
+			daedalus::core::interpreter::Interpreter& interpreter,
+			const std::shared_ptr<daedalus::core::env::Environment>& env
+		) -> daedalus::core::interpreter::RuntimeValueWrapper {
+			if(!DAE_TRACING()) {
+				return compiled(interpreter, env);
+			}
+			daedalus::core::tools::TraceNodeScope traceScope(name);
+			return compiled(interpreter, env);
+		};
+	}
+#endif
+
+	if(DAE_PROFILING(interpreter.profiler)) {
+		std::shared_ptr<daedalus::core::tools::Profiler> profiler = interpreter.profiler;
+		return [compiled, nodeType, profiler] (
+			daedalus::core::interpreter::Interpreter& interpreter,
+			const std::shared_ptr<daedalus::core::env::Environment>& env
+		) -> daedalus::core::interpreter::RuntimeValueWrapper {
+			daedalus::core::tools::ProfileScope profileScope(*profiler, nodeType);
+			return compiled(interpreter, env);
+		};
+	}
+
+	return compiled;
+}
+
+daedalus::core::interpreter::CompiledScope daedalus::core::interpreter::compile_scope(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Scope> scope
+) {
+	daedalus::core::interpreter::CompiledScope compiled;
+
+	for(const std::shared_ptr<daedalus::core::ast::Expression>& expression : scope->get_body()) {
+		compiled.body.push_back(daedalus::core::interpreter::compile_statement(interpreter, expression));
+		compiled.reprs.push_back(expression->repr());
+	}
+
+	return compiled;
+}
+
+daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::run_scope(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	const daedalus::core::interpreter::CompiledScope& scope,
+	std::vector<daedalus::core::interpreter::RuntimeResult>* results,
+	std::shared_ptr<daedalus::core::env::Environment> scope_env,
+	std::shared_ptr<daedalus::core::env::Environment> parent_env,
+	daedalus::core::interpreter::Flags escape_flag
+) {
+	if(scope_env == nullptr) {
+		scope_env = daedalus::core::env::make_environment(
+			interpreter.envValuesProperties,
+			interpreter.validationRules,
+			parent_env
+		);
+		if(parent_env == nullptr) {
+			scope_env->set_profiler(interpreter.profiler);
+		}
+	}
+
+	daedalus::core::interpreter::RuntimeValueWrapper result = daedalus::core::interpreter::wrap(nullptr);
+	daedalus::core::interpreter::RuntimeValueWrapper previous_result = daedalus::core::interpreter::wrap(
+		daedalus::core::values::null_value()
+	);
+
+	for(size_t i = 0; i < scope.body.size(); i++) {
+		result = scope.body[i](interpreter, scope_env);
+		if(daedalus::core::interpreter::flag_contains(result.flags, escape_flag)) {
+			previous_result.flags = result.flags;
+			return result.returnStatementBefore ? previous_result : result;
+		}
+		previous_result = result;
+		if(results != nullptr) {
+			results->push_back(daedalus::core::interpreter::RuntimeResult{
+				scope.reprs[i],
+				result.value->repr()
+			});
+		}
+	}
+	return result;
+}
+
+void daedalus::core::interpreter::interpret_compiled(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	const daedalus::core::interpreter::CompiledScope& program,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	if(env == nullptr) {
+		env = daedalus::core::env::make_environment(
+			interpreter.envValuesProperties,
+			interpreter.validationRules
+		);
+	}
+	if(DAE_PROFILING(interpreter.profiler) && env->get_profiler() == nullptr) {
+		env->set_profiler(interpreter.profiler);
+	}
+
+	daedalus::core::interpreter::run_scope(
+		interpreter,
+		program,
+		&results,
+		env
+	);
+}
@@ -0,0 +1,206 @@
+#include <daedalus/core/interpreter/effects.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace {
+	void sort_keys(std::vector<std::string>& keys) {
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
+	/**
+	 * Whether a statement can run alongside others: pure and only reading the environment
+	 */
+	bool is_concurrent(
+		daedalus::core::interpreter::Interpreter& interpreter,
+		const std::shared_ptr<daedalus::core::ast::Statement>& statement
+	) {
+		daedalus::core::interpreter::StatementEffects effects = daedalus::core::interpreter::analyze_effects(interpreter, statement);
+		return effects.pure && effects.writes.empty();
+	}
+
+	void push_result(
+		std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+		const std::shared_ptr<daedalus::core::ast::Statement>& statement,
+		const daedalus::core::interpreter::RuntimeValueWrapper& result
+	) {
+		results.push_back(daedalus::core::interpreter::RuntimeResult{
+			statement->repr(),
+			result.value->repr()
+		});
+	}
+}
+
+daedalus::core::interpreter::StatementEffects daedalus::core::interpreter::analyze_effects(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Statement> statement
+) {
+	daedalus::core::interpreter::StatementEffects effects = { true, {}, {} };
+	std::vector<std::shared_ptr<daedalus::core::ast::Statement>> pending = { statement };
+
+	while(!pending.empty()) {
+		std::shared_ptr<daedalus::core::ast::Statement> node = pending.back();
+		pending.pop_back();
+		if(node == nullptr) {
+			continue;
+		}
+
+		// An unparsed body could hold anything, even under a node type declared pure
+		auto nodeEffects = interpreter.nodeEffects.find(node->type());
+		if(nodeEffects == interpreter.nodeEffects.end() || !nodeEffects->second.pure || node->has_hidden_children()) {
+			effects.pure = false;
+		} else {
+			if(nodeEffects->second.reads != nullptr) {
+				std::vector<std::string> reads = nodeEffects->second.reads(node);
+				effects.reads.insert(effects.reads.end(), reads.begin(), reads.end());
+			}
+			if(nodeEffects->second.writes != nullptr) {
+				std::vector<std::string> writes = nodeEffects->second.writes(node);
+				effects.writes.insert(effects.writes.end(), writes.begin(), writes.end());
+			}
+		}
+
+		for(const std::shared_ptr<daedalus::core::ast::Expression>& child : node->get_children()) {
+			pending.push_back(child);
+		}
+	}
+
+	sort_keys(effects.reads);
+	sort_keys(effects.writes);
+	return effects;
+}
+
+daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::evaluate_scope_parallel(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Scope> scope,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	daedalus::core::tools::ThreadPool& pool,
+	std::shared_ptr<daedalus::core::env::Environment> scope_env,
+	std::shared_ptr<daedalus::core::env::Environment> parent_env,
+	daedalus::core::interpreter::Flags escape_flag,
+	daedalus::core::interpreter::ParallelScopeStats* stats
+) {
+	if(scope_env == nullptr) {
+		scope_env = daedalus::core::env::make_environment(
+			interpreter.envValuesProperties,
+			interpreter.validationRules,
+			parent_env
+		);
+		if(parent_env == nullptr) {
+			scope_env->set_profiler(interpreter.profiler);
+		}
+	}
+
+	std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body = scope->get_body();
+	bool parallel = !DAE_PROFILING(interpreter.profiler);
+
+	std::vector<bool> concurrent(body.size(), false);
+	for(size_t i = 0; parallel && i < body.size(); i++) {
+		concurrent[i] = is_concurrent(interpreter, body[i]);
+	}
+
+	if(stats != nullptr) {
+		stats->statements += body.size();
+	}
+
+	daedalus::core::interpreter::RuntimeValueWrapper result;
+	daedalus::core::interpreter::RuntimeValueWrapper previous_result = daedalus::core::interpreter::wrap(
+		daedalus::core::values::null_value()
+	);
+
+	size_t i = 0;
+	while(i < body.size()) {
+		size_t end = i;
+		while(end < body.size() && concurrent[end]) {
+			end++;
+		}
+
+		// * A single statement, evaluated as `evaluate_scope` does
+
+		if(end - i < 2) {
+			result = daedalus::core::interpreter::evaluate_statement(interpreter, body[i], scope_env);
+			if(daedalus::core::interpreter::flag_contains(result.flags, escape_flag)) {
+				previous_result.flags = result.flags;
+				return result.returnStatementBefore ? previous_result : result;
+			}
+			previous_result = result;
+			push_result(results, body[i], result);
+			i++;
+			continue;
+		}
+
+		// * A run of read-only statements, evaluated concurrently and reported in order
+
+		std::vector<daedalus::core::interpreter::RuntimeValueWrapper> wrappers(end - i);
+		std::vector<std::exception_ptr> errors(end - i, nullptr);
+		std::atomic<size_t> remaining = end - i;
+		for(size_t j = i; j < end; j++) {
+			pool.submit([&interpreter, &body, &scope_env, &wrappers, &errors, &remaining, i, j] () {
+				try {
+					wrappers[j - i] = daedalus::core::interpreter::evaluate_statement(interpreter, body[j], scope_env);
+				} catch(...) {
+					errors[j - i] = std::current_exception();
+				}
+				remaining--;
+			});
+		}
+		// Only this run is waited for, the pool can be shared with other work
+		pool.wait_until([&remaining] () {
+			return remaining == 0;
+		});
+
+		if(stats != nullptr) {
+			stats->parallelGroups++;
+			stats->parallelStatements += end - i;
+		}
+
+		for(size_t j = i; j < end; j++) {
+			if(errors[j - i] != nullptr) {
+				std::rethrow_exception(errors[j - i]);
+			}
+			result = wrappers[j - i];
+			if(daedalus::core::interpreter::flag_contains(result.flags, escape_flag)) {
+				previous_result.flags = result.flags;
+				return result.returnStatementBefore ? previous_result : result;
+			}
+			previous_result = result;
+			push_result(results, body[j], result);
+		}
+		i = end;
+	}
+
+	return result;
+}
+
+daedalus::core::interpreter::ParallelScopeStats daedalus::core::interpreter::interpret_parallel(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	daedalus::core::tools::ThreadPool& pool,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	if(env == nullptr) {
+		env = daedalus::core::env::make_environment(
+			interpreter.envValuesProperties,
+			interpreter.validationRules
+		);
+	}
+	if(DAE_PROFILING(interpreter.profiler) && env->get_profiler() == nullptr) {
+		env->set_profiler(interpreter.profiler);
+	}
+
+	daedalus::core::interpreter::ParallelScopeStats stats = { 0, 0, 0 };
+	daedalus::core::interpreter::evaluate_scope_parallel(
+		interpreter,
+		program,
+		results,
+		pool,
+		env,
+		nullptr,
+		0,
+		&stats
+	);
+	return stats;
+}
@@ -1,4 +1,231 @@
 #include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <daedalus/core/tools/trace.hpp>
+
+#include <new>
+#include <optional>
+
+namespace {
+	thread_local daedalus::core::env::EnvStats envStats = { 0, 0, 0 };
+}
+
+daedalus::core::env::EnvStats daedalus::core::env::get_env_stats() {
+	return envStats;
+}
+
+daedalus::core::env::EnvStorage::EnvStorage() :
+	entries(reinterpret_cast<daedalus::core::env::EnvEntry*>(this->inlineEntries)),
+	region(daedalus::core::values::current_region())
+{}
+
+daedalus::core::env::EnvStorage::EnvStorage(const daedalus::core::env::EnvStorage& other) :
+	entries(reinterpret_cast<daedalus::core::env::EnvEntry*>(this->inlineEntries)),
+	region(daedalus::core::values::current_region())
+{
+	if(other.count > DAE_ENV_INLINE_CAPACITY) {
+		this->entries = this->allocate<daedalus::core::env::EnvEntry>(other.capacity);
+		this->capacity = other.capacity;
+	}
+	if(other.slotCount != 0) {
+		this->slots = this->allocate<uint32_t>(other.slotCount);
+		this->slotCount = other.slotCount;
+		std::copy(other.slots, other.slots + other.slotCount, this->slots);
+	}
+	for(; this->count < other.count; this->count++) {
+		const daedalus::core::env::EnvEntry& entry = other.entries[this->count];
+		new (&this->entries[this->count]) daedalus::core::env::EnvEntry{
+			entry.key,
+			make_value(*entry.value),
+			entry.hash
+		};
+	}
+}
+
+daedalus::core::env::EnvStorage::~EnvStorage() {
+	this->clear();
+	if(!this->is_inline()) {
+		this->deallocate(this->entries, this->capacity);
+	}
+}
+
+daedalus::core::env::EnvValue* daedalus::core::env::EnvStorage::find(std::string_view key) {
+	return const_cast<daedalus::core::env::EnvValue*>(static_cast<const daedalus::core::env::EnvStorage*>(this)->find(key));
+}
+
+const daedalus::core::env::EnvValue* daedalus::core::env::EnvStorage::find(std::string_view key) const {
+	// Comparing a few short keys is cheaper than hashing one
+	if(this->slotCount == 0) {
+		for(size_t i = 0; i < this->count; i++) {
+			if(this->entries[i].key == key) {
+				return this->entries[i].value;
+			}
+		}
+		return nullptr;
+	}
+
+	size_t hash = std::hash<std::string_view>()(key);
+	size_t mask = this->slotCount - 1;
+	for(size_t slot = hash & mask; this->slots[slot] != 0; slot = (slot + 1) & mask) {
+		const daedalus::core::env::EnvEntry& entry = this->entries[this->slots[slot] - 1];
+		if(entry.hash == hash && entry.key == key) {
+			return entry.value;
+		}
+	}
+	return nullptr;
+}
+
+daedalus::core::env::EnvValue& daedalus::core::env::EnvStorage::assign(std::string_view key, daedalus::core::env::EnvValue value) {
+	daedalus::core::env::EnvValue* existing = this->find(key);
+	if(existing != nullptr) {
+		*existing = std::move(value);
+		return *existing;
+	}
+
+	// Everything that can run out of quota is allocated before the entry is added, leaving the storage untouched
+	if(this->count == this->capacity) {
+		this->grow();
+	}
+	if(this->count + 1 > DAE_ENV_INLINE_CAPACITY && (this->count + 1) * 2 > this->slotCount) {
+		this->rebuild_slots(this->count + 1);
+	}
+	new (&this->entries[this->count]) daedalus::core::env::EnvEntry{
+		std::string(key),
+		this->make_value(std::move(value)),
+		0
+	};
+	this->count++;
+
+	if(this->slotCount != 0) {
+		this->insert_slot(this->count - 1);
+	}
+
+	return *this->entries[this->count - 1].value;
+}
+
+size_t daedalus::core::env::EnvStorage::size() const {
+	return this->count;
+}
+
+bool daedalus::core::env::EnvStorage::empty() const {
+	return this->count == 0;
+}
+
+void daedalus::core::env::EnvStorage::clear() {
+	for(size_t i = 0; i < this->count; i++) {
+		this->destroy_value(this->entries[i].value);
+		this->entries[i].~EnvEntry();
+	}
+	this->count = 0;
+
+	if(this->slotCount != 0) {
+		this->deallocate(this->slots, this->slotCount);
+		this->slots = nullptr;
+		this->slotCount = 0;
+	}
+}
+
+daedalus::core::env::EnvEntry* daedalus::core::env::EnvStorage::begin() {
+	return this->entries;
+}
+
+daedalus::core::env::EnvEntry* daedalus::core::env::EnvStorage::end() {
+	return this->entries + this->count;
+}
+
+const daedalus::core::env::EnvEntry* daedalus::core::env::EnvStorage::begin() const {
+	return this->entries;
+}
+
+const daedalus::core::env::EnvEntry* daedalus::core::env::EnvStorage::end() const {
+	return this->entries + this->count;
+}
+
+bool daedalus::core::env::EnvStorage::is_inline() const {
+	return this->entries == reinterpret_cast<const daedalus::core::env::EnvEntry*>(this->inlineEntries);
+}
+
+template<typename T>
+T* daedalus::core::env::EnvStorage::allocate(size_t n) {
+	if(this->region != nullptr) {
+		return daedalus::core::values::RegionAllocator<T>(this->region).allocate(n);
+	}
+	return std::allocator<T>().allocate(n);
+}
+
+template<typename T>
+void daedalus::core::env::EnvStorage::deallocate(T* block, size_t n) {
+	if(this->region != nullptr) {
+		daedalus::core::values::RegionAllocator<T>(this->region).deallocate(block, n);
+	} else {
+		std::allocator<T>().deallocate(block, n);
+	}
+}
+
+daedalus::core::env::EnvValue* daedalus::core::env::EnvStorage::make_value(daedalus::core::env::EnvValue value) {
+	daedalus::core::env::EnvValue* block = this->region != nullptr ?
+		this->allocate<daedalus::core::env::EnvValue>(1) :
+		daedalus::core::values::PoolAllocator<daedalus::core::env::EnvValue>().allocate(1);
+	return new (block) daedalus::core::env::EnvValue(std::move(value));
+}
+
+void daedalus::core::env::EnvStorage::destroy_value(daedalus::core::env::EnvValue* value) {
+	value->~EnvValue();
+	if(this->region != nullptr) {
+		this->deallocate(value, 1);
+	} else {
+		daedalus::core::values::PoolAllocator<daedalus::core::env::EnvValue>().deallocate(value, 1);
+	}
+}
+
+void daedalus::core::env::EnvStorage::grow() {
+	size_t capacity = this->capacity * 2;
+	daedalus::core::env::EnvEntry* entries = this->allocate<daedalus::core::env::EnvEntry>(capacity);
+
+	for(size_t i = 0; i < this->count; i++) {
+		new (&entries[i]) daedalus::core::env::EnvEntry(std::move(this->entries[i]));
+		this->entries[i].~EnvEntry();
+	}
+	if(!this->is_inline()) {
+		this->deallocate(this->entries, this->capacity);
+	}
+
+	this->entries = entries;
+	this->capacity = capacity;
+}
+
+void daedalus::core::env::EnvStorage::rebuild_slots(size_t count) {
+	size_t slotCount = 2 * DAE_ENV_INLINE_CAPACITY;
+	while(slotCount < count * 2) {
+		slotCount *= 2;
+	}
+	uint32_t* slots = this->allocate<uint32_t>(slotCount);
+	std::fill(slots, slots + slotCount, 0);
+
+	if(this->slotCount != 0) {
+		this->deallocate(this->slots, this->slotCount);
+	}
+	this->slots = slots;
+	this->slotCount = slotCount;
+
+	for(size_t i = 0; i < this->count; i++) {
+		this->insert_slot(i);
+	}
+}
+
+void daedalus::core::env::EnvStorage::insert_slot(size_t index) {
+	// Entries searched linearly until now have no hash yet
+	daedalus::core::env::EnvEntry& entry = this->entries[index];
+	if(entry.hash == 0) {
+		entry.hash = std::hash<std::string_view>()(entry.key);
+	}
+
+	size_t mask = this->slotCount - 1;
+	size_t slot = entry.hash & mask;
+	while(this->slots[slot] != 0) {
+		slot = (slot + 1) & mask;
+	}
+	this->slots[slot] = static_cast<uint32_t>(index + 1);
+}
 
 daedalus::core::env::Environment::Environment(
 	std::vector<std::string> envValuesProperties,
@@ -8,50 +235,98 @@ daedalus::core::env::Environment::Environment(
 	envValuesProperties(envValuesProperties),
 	validationRules(validationRules),
 	parent(parent),
-	values()
+	values(),
+	profiler(parent != nullptr ? parent->profiler : nullptr)
 {}
 
-bool daedalus::core::env::Environment::has_value(std::string key) {
-	return this->values.find(key) != this->values.end();
+bool daedalus::core::env::Environment::has_value(std::string_view key) {
+	return this->find_value(key) != nullptr;
 }
 
 std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Environment::set_value(
-	std::string key,
+	std::string_view key,
 	std::shared_ptr<daedalus::core::values::RuntimeValue> value
 ) {
 	if(!this->has_value(key)) {
 		DAE_ASSERT_TRUE(
 			this->parent != nullptr,
-			std::runtime_error("Trying to set non-declared variable " + key)
+			std::runtime_error("Trying to set non-declared variable " + std::string(key))
 		)
 		return this->parent->set_value(key, value);
 	}
 
-	auto envValue = daedalus::core::env::EnvValue{
-		value,
-		this->values.at(key).properties
-	};
+	// Counted by the environment holding the key only, not by every scope the lookup went through
+	envStats.sets++;
+
+	std::optional<daedalus::core::tools::ProfileScope> profileScope;
+	if(DAE_PROFILING(this->profiler)) {
+		profileScope.emplace(*this->profiler, DAE_PROFILE_ENV_SET);
+	}
+	if(DAE_TRACING()) {
+		daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::ENV_SET, std::string(key));
+	}
+
+	// The entry is only copied when a rule can change it
+	std::optional<daedalus::core::env::EnvValue> envValue;
 
 	for(const daedalus::core::env::EnvValidationRule& rule : this->validationRules) {
 		if(std::find(rule.sensitivity.begin(), rule.sensitivity.end(), daedalus::core::env::ValidationRuleSensitivity::SET) != rule.sensitivity.end()) {
+			std::optional<daedalus::core::tools::ProfileScope> ruleScope;
+			if(DAE_PROFILING(this->profiler)) {
+				ruleScope.emplace(*this->profiler, DAE_PROFILE_ENV_VALIDATION);
+			}
+			if(DAE_TRACING()) {
+				daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::VALIDATION_RULE, std::string(key));
+			}
+			// Rules can reach this environment, the entry is looked up again for each of them
+			const daedalus::core::env::EnvValue* current = this->find_value(key);
+			if(!envValue.has_value()) {
+				envValue = daedalus::core::env::EnvValue{
+					value,
+					current->properties
+				};
+			}
 			envValue = rule.validationFunction(
-				this->values.at(key),
-				envValue.value,
-				key
+				*current,
+				envValue->value,
+				std::string(key)
 			);
 		}
 	}
 
-	this->values.at(key) = envValue;
+	daedalus::core::env::EnvValue& ownValue = this->own_value(key);
+	if(envValue.has_value()) {
+		ownValue = std::move(*envValue);
+	} else {
+		ownValue.value = value;
+	}
+
+	// Listeners can reach this environment too, they get their own reference to the stored value
+	if(!this->listeners.empty()) {
+		std::string keyString = std::string(key);
+		std::shared_ptr<daedalus::core::values::RuntimeValue> stored = ownValue.value;
+		for(const auto& [id, listener] : this->listeners) {
+			listener(keyString, stored);
+		}
+	}
 
 	return value;
 }
 
 std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Environment::init_value(
-	std::string key,
+	std::string_view key,
 	std::shared_ptr<daedalus::core::values::RuntimeValue> value,
 	std::unordered_map<std::string, std::string> properties
 ) {
+	envStats.inits++;
+
+	std::optional<daedalus::core::tools::ProfileScope> profileScope;
+	if(DAE_PROFILING(this->profiler)) {
+		profileScope.emplace(*this->profiler, DAE_PROFILE_ENV_INIT);
+	}
+	if(DAE_TRACING()) {
+		daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::ENV_INIT, std::string(key));
+	}
 
 	for(const auto& [prop_key, prop_value] : properties) {
 		DAE_ASSERT_TRUE(
@@ -62,7 +337,7 @@ std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Envir
 
 	DAE_ASSERT_TRUE(
 		!this->has_value(key),
-		std::runtime_error("Trying to redeclare an existing variable " + key)
+		std::runtime_error("Trying to redeclare an existing variable " + std::string(key))
 	)
 
 	auto envValue = daedalus::core::env::EnvValue{
@@ -72,38 +347,154 @@ std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Envir
 
 	for(const daedalus::core::env::EnvValidationRule& rule : this->validationRules) {
 		if(std::find(rule.sensitivity.begin(), rule.sensitivity.end(), daedalus::core::env::ValidationRuleSensitivity::INIT) != rule.sensitivity.end()) {
+			std::optional<daedalus::core::tools::ProfileScope> ruleScope;
+			if(DAE_PROFILING(this->profiler)) {
+				ruleScope.emplace(*this->profiler, DAE_PROFILE_ENV_VALIDATION);
+			}
+			if(DAE_TRACING()) {
+				daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::VALIDATION_RULE, std::string(key));
+			}
 			envValue = rule.validationFunction(
 				envValue,
 				nullptr,
-				key
+				std::string(key)
 			);
 		}
 	}
 
-	this->values[key] = envValue;
+	this->values.assign(key, std::move(envValue));
 
 	return value;
 }
 
-std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Environment::get_value(std::string key) {
-	if(!this->has_value(key)) {
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::env::Environment::get_value(std::string_view key) {
+	const daedalus::core::env::EnvValue* found = this->find_value(key);
+	if(found == nullptr) {
 		DAE_ASSERT_TRUE(
 			this->parent != nullptr,
-			std::runtime_error("Trying to get non-declared variable " + key)
+			std::runtime_error("Trying to get non-declared variable " + std::string(key))
 		)
 		return this->parent->get_value(key);
 	}
 
-	daedalus::core::env::EnvValue envValue = this->values.at(key);
+	envStats.gets++;
+
+	std::optional<daedalus::core::tools::ProfileScope> profileScope;
+	if(DAE_PROFILING(this->profiler)) {
+		profileScope.emplace(*this->profiler, DAE_PROFILE_ENV_GET);
+	}
+	if(DAE_TRACING()) {
+		daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::ENV_GET, std::string(key));
+	}
+
+	// The value is kept before the rules run, as they can reach this environment
+	std::shared_ptr<daedalus::core::values::RuntimeValue> value = found->value;
+
+	// The entry is only copied when a rule reads it
+	std::optional<daedalus::core::env::EnvValue> envValue;
 
 	for(const daedalus::core::env::EnvValidationRule& rule : this->validationRules) {
 		if(std::find(rule.sensitivity.begin(), rule.sensitivity.end(), daedalus::core::env::ValidationRuleSensitivity::GET) != rule.sensitivity.end()) {
+			std::optional<daedalus::core::tools::ProfileScope> ruleScope;
+			if(DAE_PROFILING(this->profiler)) {
+				ruleScope.emplace(*this->profiler, DAE_PROFILE_ENV_VALIDATION);
+			}
+			if(DAE_TRACING()) {
+				daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::VALIDATION_RULE, std::string(key));
+			}
+			if(!envValue.has_value()) {
+				envValue = *found;
+			}
 			envValue = rule.validationFunction(
-				envValue,
+				*envValue,
 				nullptr,
-				key
+				std::string(key)
 			);
 		}
 	}
-	return this->values.at(key).value;
+	return value;
+}
+
+void daedalus::core::env::Environment::set_profiler(std::shared_ptr<daedalus::core::tools::Profiler> profiler) {
+	this->profiler = profiler;
+}
+
+std::shared_ptr<daedalus::core::tools::Profiler> daedalus::core::env::Environment::get_profiler() {
+	return this->profiler;
+}
+
+size_t daedalus::core::env::Environment::add_listener(daedalus::core::env::EnvListener listener) {
+	size_t id = this->nextListenerId++;
+	this->listeners.emplace_back(id, std::move(listener));
+	return id;
+}
+
+void daedalus::core::env::Environment::remove_listener(size_t id) {
+	this->listeners.erase(
+		std::remove_if(this->listeners.begin(), this->listeners.end(), [id] (const std::pair<size_t, daedalus::core::env::EnvListener>& listener) {
+			return listener.first == id;
+		}),
+		this->listeners.end()
+	);
+}
+
+void daedalus::core::env::Environment::clear() {
+	this->values.clear();
+}
+
+std::shared_ptr<daedalus::core::env::Environment> daedalus::core::env::Environment::fork() {
+	if(!this->values.empty()) {
+		auto frozen = this->base == nullptr ?
+			std::make_shared<daedalus::core::env::EnvStorage>() :
+			std::make_shared<daedalus::core::env::EnvStorage>(*this->base);
+		for(daedalus::core::env::EnvEntry& entry : this->values) {
+			frozen->assign(entry.key, std::move(*entry.value));
+		}
+		this->values.clear();
+		this->base = frozen;
+	}
+
+	auto forked = daedalus::core::env::make_environment(
+		this->envValuesProperties,
+		this->validationRules,
+		this->parent
+	);
+	forked->base = this->base;
+	forked->profiler = this->profiler;
+
+	return forked;
+}
+
+const daedalus::core::env::EnvValue* daedalus::core::env::Environment::find_value(std::string_view key) {
+	const daedalus::core::env::EnvValue* ownValue = this->values.find(key);
+	if(ownValue != nullptr) {
+		return ownValue;
+	}
+
+	if(this->base != nullptr) {
+		return this->base->find(key);
+	}
+
+	return nullptr;
+}
+
+daedalus::core::env::EnvValue& daedalus::core::env::Environment::own_value(std::string_view key) {
+	daedalus::core::env::EnvValue* ownValue = this->values.find(key);
+	if(ownValue != nullptr) {
+		return *ownValue;
+	}
+	return this->values.assign(key, *this->base->find(key));
+}
+
+std::shared_ptr<daedalus::core::env::Environment> daedalus::core::env::make_environment(
+	std::vector<std::string> envValuesProperties,
+	std::vector<daedalus::core::env::EnvValidationRule> validationRules,
+	std::shared_ptr<daedalus::core::env::Environment> parent
+) {
+	return daedalus::core::values::allocate_in_region<daedalus::core::env::Environment>(
+		std::allocator<daedalus::core::env::Environment>(),
+		std::move(envValuesProperties),
+		std::move(validationRules),
+		std::move(parent)
+	);
 }
@@ -1,4 +1,8 @@
 #include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/interpreter/memo.hpp>
+#include <daedalus/core/tools/trace.hpp>
+
+#include <optional>
 
 daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::wrap(
     std::shared_ptr<daedalus::core::values::RuntimeValue> value,
@@ -25,11 +29,26 @@ daedalus::core::interpreter::Flags daedalus::core::interpreter::flag_remove(
     return static_cast<daedalus::core::interpreter::Flags>(static_cast<size_t>(source) & ~static_cast<size_t>(to_remove));
 }
 
+daedalus::core::interpreter::NodeEffects daedalus::core::interpreter::make_node_effects(
+	bool pure,
+	daedalus::core::interpreter::EffectKeysFunction reads,
+	daedalus::core::interpreter::EffectKeysFunction writes,
+	bool memoize
+) {
+	return daedalus::core::interpreter::NodeEffects{
+		pure,
+		reads,
+		writes,
+		memoize
+	};
+}
+
 void daedalus::core::interpreter::setup_interpreter(
 	daedalus::core::interpreter::Interpreter& interpreter,
 	std::unordered_map<std::string, ParseStatementFunction> nodeEvaluationFunctions,
 	std::vector<std::string> envValuesProperties,
-	std::vector<daedalus::core::env::EnvValidationRule> validationRules
+	std::vector<daedalus::core::env::EnvValidationRule> validationRules,
+	std::unordered_map<std::string, daedalus::core::interpreter::CompileStatementFunction> nodeCompilationFunctions
 ) {
 	interpreter.envValuesProperties = envValuesProperties;
 
@@ -42,11 +61,108 @@ void daedalus::core::interpreter::setup_interpreter(
 		std::shared_ptr<daedalus::core::env::Environment> env
 	) -> daedalus::core::interpreter::RuntimeValueWrapper {
 	    return daedalus::core::interpreter::wrap(
-			std::make_shared<daedalus::core::values::NumberValue>(
-    			std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(statement)->get_value()
-    		)
+			std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(statement)->get_constant()
 		);
 	};
+
+	interpreter.nodeEffects["NumberExpression"] = daedalus::core::interpreter::make_node_effects();
+
+	interpreter.nodeCompilationFunctions = nodeCompilationFunctions;
+	interpreter.nodeCompilationFunctions["NumberExpression"] = [] (
+		daedalus::core::interpreter::Interpreter& interpreter,
+		std::shared_ptr<daedalus::core::ast::Statement> statement
+	) -> daedalus::core::interpreter::CompiledStatement {
+		auto value = std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(statement)->get_constant();
+		return [value] (
+			daedalus::core::interpreter::Interpreter& interpreter,
+			const std::shared_ptr<daedalus::core::env::Environment>& env
+		) -> daedalus::core::interpreter::RuntimeValueWrapper {
+			return daedalus::core::interpreter::wrap(value);
+		};
+	};
+}
+
+namespace {
+	/**
+	 * Get the root environment of a program, configured for the interpreter
+	 */
+	std::shared_ptr<daedalus::core::env::Environment> prepare_program_env(
+		daedalus::core::interpreter::Interpreter& interpreter,
+		std::shared_ptr<daedalus::core::env::Environment> env
+	) {
+		if(env == nullptr) {
+			env = daedalus::core::env::make_environment(
+				interpreter.envValuesProperties,
+				interpreter.validationRules
+			);
+		}
+		if(DAE_PROFILING(interpreter.profiler) && env->get_profiler() == nullptr) {
+			env->set_profiler(interpreter.profiler);
+		}
+		if(interpreter.memoCache != nullptr) {
+			interpreter.memoCache->watch(env);
+		}
+		return env;
+	}
+
+	/**
+	 * Evaluate the statements of a scope in order, shared by `evaluate_scope`, `interpret` and `try_interpret`
+	 * @param error Where to store the first error instead of throwing it, with the index of its statement (`nullptr` to throw)
+	 * @return The result of the last statement evaluated, or of the statement before an escaping one if it asks for it
+	 */
+	daedalus::core::interpreter::RuntimeValueWrapper evaluate_body(
+		daedalus::core::interpreter::Interpreter& interpreter,
+		const std::shared_ptr<daedalus::core::ast::Scope>& scope,
+		std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+		const std::shared_ptr<daedalus::core::env::Environment>& scope_env,
+		daedalus::core::interpreter::Flags escape_flag,
+		std::optional<daedalus::core::tools::Error>* error
+	) {
+		daedalus::core::interpreter::RuntimeValueWrapper result = daedalus::core::interpreter::wrap(nullptr);
+		daedalus::core::interpreter::RuntimeValueWrapper previous_result = daedalus::core::interpreter::wrap(
+			daedalus::core::values::null_value()
+		);
+
+		const std::vector<std::shared_ptr<daedalus::core::ast::Expression>>& body = scope->get_body();
+
+		for(size_t i = 0; i < body.size(); i++) {
+			const std::shared_ptr<daedalus::core::ast::Expression>& statement = body[i];
+
+			if(error == nullptr) {
+				result = daedalus::core::interpreter::evaluate_statement(interpreter, statement, scope_env);
+			} else {
+				std::string type = statement->type();
+				if(interpreter.nodeEvaluationFunctions.find(type) == interpreter.nodeEvaluationFunctions.end()) {
+					if(DAE_TRACING()) {
+						daedalus::core::tools::trace_error();
+					}
+					*error = daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNKNOWN_STATEMENT, i };
+					return daedalus::core::interpreter::wrap(nullptr);
+				}
+
+				try {
+					result = daedalus::core::interpreter::evaluate_statement(interpreter, statement, scope_env);
+				} catch(const std::exception& e) {
+					if(DAE_TRACING()) {
+						daedalus::core::tools::trace_error();
+					}
+					*error = daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::EVALUATION_ERROR, i, e.what() };
+					return daedalus::core::interpreter::wrap(nullptr);
+				}
+			}
+
+			if(daedalus::core::interpreter::flag_contains(result.flags, escape_flag)) {
+				previous_result.flags = result.flags;
+				return result.returnStatementBefore ? previous_result : result;
+			}
+			previous_result = result;
+			results.push_back(daedalus::core::interpreter::RuntimeResult{
+				statement->repr(),
+				result.value->repr()
+			});
+		}
+		return result;
+	}
 }
 
 daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::evaluate_statement(
@@ -54,16 +170,41 @@ daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::ev
 	std::shared_ptr<daedalus::core::ast::Statement> statement,
 	std::shared_ptr<daedalus::core::env::Environment> env
 ) {
-	for(const auto& [nodeType, evaluateFn] : interpreter.nodeEvaluationFunctions) {
-		if(statement->type() == nodeType) {
-			return evaluateFn(interpreter, statement, env);
-		}
-	}
+	auto evaluateFn = interpreter.nodeEvaluationFunctions.find(statement->type());
 
 	DAE_ASSERT_TRUE(
-		false,
+		evaluateFn != interpreter.nodeEvaluationFunctions.end(),
 		std::runtime_error("Trying to evaluate unknown statement " + statement->type())
 	)
+
+	std::optional<daedalus::core::tools::TraceNodeScope> traceScope;
+	if(DAE_TRACING()) {
+		traceScope.emplace(evaluateFn->first);
+	}
+
+	if(interpreter.memoCache != nullptr) {
+		auto effects = interpreter.nodeEffects.find(evaluateFn->first);
+		if(effects != interpreter.nodeEffects.end() && effects->second.memoize) {
+			return interpreter.memoCache->evaluate(interpreter, statement, env, [&evaluateFn] (
+				daedalus::core::interpreter::Interpreter& interpreter,
+				std::shared_ptr<daedalus::core::ast::Statement> statement,
+				std::shared_ptr<daedalus::core::env::Environment> env
+			) -> daedalus::core::interpreter::RuntimeValueWrapper {
+				if(DAE_PROFILING(interpreter.profiler)) {
+					daedalus::core::tools::ProfileScope profileScope(*interpreter.profiler, evaluateFn->first);
+					return evaluateFn->second(interpreter, statement, env);
+				}
+				return evaluateFn->second(interpreter, statement, env);
+			});
+		}
+	}
+
+	if(DAE_PROFILING(interpreter.profiler)) {
+		daedalus::core::tools::ProfileScope profileScope(*interpreter.profiler, evaluateFn->first);
+		return evaluateFn->second(interpreter, statement, env);
+	}
+
+	return evaluateFn->second(interpreter, statement, env);
 }
 
 daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::evaluate_scope(
@@ -75,47 +216,65 @@ daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::ev
 	Flags escape_flag
 ) {
 	if(scope_env == nullptr) {
-		scope_env = std::make_shared<daedalus::core::env::Environment>(
+		scope_env = daedalus::core::env::make_environment(
 			interpreter.envValuesProperties,
 			interpreter.validationRules,
 			parent_env
 		);
+		if(parent_env == nullptr) {
+			scope_env->set_profiler(interpreter.profiler);
+		}
 	}
 
-	daedalus::core::interpreter::RuntimeValueWrapper result;
-	daedalus::core::interpreter::RuntimeValueWrapper previous_result = daedalus::core::interpreter::wrap(
-        std::make_shared<daedalus::core::values::NullValue>()
-	);
+	return evaluate_body(interpreter, scope, results, scope_env, escape_flag, nullptr);
+}
+
+void daedalus::core::interpreter::interpret(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	env = prepare_program_env(interpreter, env);
 
-	for(std::shared_ptr<daedalus::core::ast::Statement> statement : scope->get_body()) {
-		result = daedalus::core::interpreter::evaluate_statement(interpreter, statement, scope_env);
-		if(daedalus::core::interpreter::flag_contains(result.flags, escape_flag)) {
-			previous_result.flags = result.flags;
-			return result.returnStatementBefore ? previous_result : result;
+	try {
+		evaluate_body(interpreter, program, results, env, 0, nullptr);
+	} catch(const std::exception& e) {
+		if(DAE_TRACING()) {
+			daedalus::core::tools::trace_error();
 		}
-		previous_result = result;
-		results.push_back(daedalus::core::interpreter::RuntimeResult{
-		    statement->repr(),
-			result.value->repr()
-		});
+		throw;
 	}
-	return result;
 }
 
-void daedalus::core::interpreter::interpret(
+daedalus::core::values::RegionStats daedalus::core::interpreter::interpret_in_region(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	size_t quota,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) {
+	auto region = std::make_shared<daedalus::core::values::Region>(quota);
+	{
+		daedalus::core::values::RegionScope scope(region);
+		daedalus::core::interpreter::interpret(interpreter, results, program, env);
+	}
+	// The region is released with the last reference, here unless a value escaped the run
+	return region->get_stats();
+}
+
+daedalus::core::tools::Result<void> daedalus::core::interpreter::try_interpret(
 	daedalus::core::interpreter::Interpreter& interpreter,
 	std::vector<daedalus::core::interpreter::RuntimeResult>& results,
-	std::shared_ptr<daedalus::core::ast::Scope> program
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	std::shared_ptr<daedalus::core::env::Environment> env
 ) {
-	auto env = std::make_shared<daedalus::core::env::Environment>(
-		interpreter.envValuesProperties,
-		interpreter.validationRules
-	);
-
-	daedalus::core::interpreter::evaluate_scope(
-		interpreter,
-		program,
-		results,
-		env
-	);
+	env = prepare_program_env(interpreter, env);
+
+	std::optional<daedalus::core::tools::Error> error;
+	evaluate_body(interpreter, program, results, env, 0, &error);
+	if(error.has_value()) {
+		return *error;
+	}
+	return daedalus::core::tools::Result<void>();
 }
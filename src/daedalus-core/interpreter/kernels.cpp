@@ -0,0 +1,324 @@
+#include <daedalus/core/interpreter/kernels.hpp>
+
+#include <atomic>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define DAE_HAS_AVX2_KERNELS 1
+	#define DAE_AVX2 __attribute__((target("avx2")))
+	#include <immintrin.h>
+#else
+	#define DAE_HAS_AVX2_KERNELS 0
+#endif
+
+namespace {
+
+	#pragma region Backend
+
+	daedalus::core::kernels::KernelBackend resolve_backend(daedalus::core::kernels::KernelBackend backend) {
+	#if DAE_HAS_AVX2_KERNELS
+		bool supportsAvx2 = __builtin_cpu_supports("avx2");
+	#else
+		bool supportsAvx2 = false;
+	#endif
+		if(backend == daedalus::core::kernels::KernelBackend::SCALAR || !supportsAvx2) {
+			return daedalus::core::kernels::KernelBackend::SCALAR;
+		}
+		return daedalus::core::kernels::KernelBackend::AVX2;
+	}
+
+	std::atomic<daedalus::core::kernels::KernelBackend>& current_backend() {
+		static std::atomic<daedalus::core::kernels::KernelBackend> backend(
+			resolve_backend(daedalus::core::kernels::KernelBackend::AUTO)
+		);
+		return backend;
+	}
+
+	#pragma endregion
+
+	#pragma region Operands
+
+	struct Array {
+		const double* data;
+
+		double at(size_t i) const {
+			return this->data[i];
+		}
+	#if DAE_HAS_AVX2_KERNELS
+		DAE_AVX2 __m256d simd(size_t i) const {
+			return _mm256_loadu_pd(this->data + i);
+		}
+	#endif
+	};
+
+	struct Broadcast {
+		double value;
+
+		double at(size_t i) const {
+			return this->value;
+		}
+	#if DAE_HAS_AVX2_KERNELS
+		DAE_AVX2 __m256d simd(size_t i) const {
+			return _mm256_set1_pd(this->value);
+		}
+	#endif
+	};
+
+	#pragma endregion
+
+	#pragma region Operations
+
+	#if DAE_HAS_AVX2_KERNELS
+		#define DAE_SIMD_OPERATION(expression) \
+		DAE_AVX2 static __m256d simd(__m256d a, __m256d b) { \
+			return expression; \
+		}
+		#define DAE_SIMD_COMPARISON(predicate) \
+		DAE_SIMD_OPERATION(_mm256_and_pd(_mm256_cmp_pd(a, b, predicate), _mm256_set1_pd(1)))
+	#else
+		#define DAE_SIMD_OPERATION(expression)
+		#define DAE_SIMD_COMPARISON(predicate)
+	#endif
+
+	struct Add {
+		static double scalar(double a, double b) { return a + b; }
+		DAE_SIMD_OPERATION(_mm256_add_pd(a, b))
+	};
+	struct Sub {
+		static double scalar(double a, double b) { return a - b; }
+		DAE_SIMD_OPERATION(_mm256_sub_pd(a, b))
+	};
+	struct Mul {
+		static double scalar(double a, double b) { return a * b; }
+		DAE_SIMD_OPERATION(_mm256_mul_pd(a, b))
+	};
+	struct Div {
+		static double scalar(double a, double b) { return a / b; }
+		DAE_SIMD_OPERATION(_mm256_div_pd(a, b))
+	};
+	struct Lt {
+		static double scalar(double a, double b) { return a < b; }
+		DAE_SIMD_COMPARISON(_CMP_LT_OQ)
+	};
+	struct Le {
+		static double scalar(double a, double b) { return a <= b; }
+		DAE_SIMD_COMPARISON(_CMP_LE_OQ)
+	};
+	struct Gt {
+		static double scalar(double a, double b) { return a > b; }
+		DAE_SIMD_COMPARISON(_CMP_GT_OQ)
+	};
+	struct Ge {
+		static double scalar(double a, double b) { return a >= b; }
+		DAE_SIMD_COMPARISON(_CMP_GE_OQ)
+	};
+	struct Eq {
+		static double scalar(double a, double b) { return a == b; }
+		DAE_SIMD_COMPARISON(_CMP_EQ_OQ)
+	};
+	struct Ne {
+		static double scalar(double a, double b) { return a != b; }
+		DAE_SIMD_COMPARISON(_CMP_NEQ_UQ)
+	};
+
+	// Same semantics as `_mm256_min_pd` / `_mm256_max_pd` : the second operand wins on NaN
+	struct Min {
+		static double scalar(double a, double b) { return a < b ? a : b; }
+		DAE_SIMD_OPERATION(_mm256_min_pd(a, b))
+	};
+	struct Max {
+		static double scalar(double a, double b) { return a > b ? a : b; }
+		DAE_SIMD_OPERATION(_mm256_max_pd(a, b))
+	};
+
+	#pragma endregion
+
+	#pragma region Kernels
+
+	template<typename Operation, typename Left, typename Right>
+	void scalar_kernel(Left left, Right right, double* out, size_t size) {
+		for(size_t i = 0; i < size; i++) {
+			out[i] = Operation::scalar(left.at(i), right.at(i));
+		}
+	}
+
+	template<typename Operation>
+	double scalar_reduce(const double* vector, size_t size, double identity) {
+		double accumulator = identity;
+		for(size_t i = 0; i < size; i++) {
+			accumulator = Operation::scalar(accumulator, vector[i]);
+		}
+		return accumulator;
+	}
+
+	#if DAE_HAS_AVX2_KERNELS
+	template<typename Operation, typename Left, typename Right>
+	DAE_AVX2 void avx2_kernel(Left left, Right right, double* out, size_t size) {
+		size_t i = 0;
+		for(; i + 4 <= size; i += 4) {
+			_mm256_storeu_pd(out + i, Operation::simd(left.simd(i), right.simd(i)));
+		}
+		for(; i < size; i++) {
+			out[i] = Operation::scalar(left.at(i), right.at(i));
+		}
+	}
+
+	template<typename Operation>
+	DAE_AVX2 double avx2_reduce(const double* vector, size_t size, double identity) {
+		__m256d first = _mm256_set1_pd(identity);
+		__m256d second = _mm256_set1_pd(identity);
+		size_t i = 0;
+		for(; i + 8 <= size; i += 8) {
+			first = Operation::simd(first, _mm256_loadu_pd(vector + i));
+			second = Operation::simd(second, _mm256_loadu_pd(vector + i + 4));
+		}
+		for(; i + 4 <= size; i += 4) {
+			first = Operation::simd(first, _mm256_loadu_pd(vector + i));
+		}
+		alignas(32) double lanes[4];
+		_mm256_store_pd(lanes, Operation::simd(first, second));
+		double accumulator = Operation::scalar(Operation::scalar(lanes[0], lanes[1]), Operation::scalar(lanes[2], lanes[3]));
+		for(; i < size; i++) {
+			accumulator = Operation::scalar(accumulator, vector[i]);
+		}
+		return accumulator;
+	}
+	#endif
+
+	template<typename Operation, typename Left, typename Right>
+	void run_kernel(Left left, Right right, double* out, size_t size) {
+	#if DAE_HAS_AVX2_KERNELS
+		if(current_backend().load(std::memory_order_relaxed) == daedalus::core::kernels::KernelBackend::AVX2) {
+			avx2_kernel<Operation>(left, right, out, size);
+			return;
+		}
+	#endif
+		scalar_kernel<Operation>(left, right, out, size);
+	}
+
+	template<typename Operation>
+	double run_reduce(const double* vector, size_t size, double identity) {
+	#if DAE_HAS_AVX2_KERNELS
+		if(current_backend().load(std::memory_order_relaxed) == daedalus::core::kernels::KernelBackend::AVX2) {
+			return avx2_reduce<Operation>(vector, size, identity);
+		}
+	#endif
+		return scalar_reduce<Operation>(vector, size, identity);
+	}
+
+	template<typename Left, typename Right>
+	void dispatch(daedalus::core::kernels::VectorOperation operation, Left left, Right right, double* out, size_t size) {
+		switch(operation) {
+			case daedalus::core::kernels::VectorOperation::ADD: run_kernel<Add>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::SUB: run_kernel<Sub>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::MUL: run_kernel<Mul>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::DIV: run_kernel<Div>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::LT: run_kernel<Lt>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::LE: run_kernel<Le>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::GT: run_kernel<Gt>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::GE: run_kernel<Ge>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::EQ: run_kernel<Eq>(left, right, out, size); break;
+			case daedalus::core::kernels::VectorOperation::NE: run_kernel<Ne>(left, right, out, size); break;
+		}
+	}
+
+	#pragma endregion
+}
+
+void daedalus::core::kernels::set_backend(daedalus::core::kernels::KernelBackend backend) {
+	current_backend().store(resolve_backend(backend));
+}
+
+daedalus::core::kernels::KernelBackend daedalus::core::kernels::get_backend() {
+	return current_backend().load();
+}
+
+void daedalus::core::kernels::apply(
+	daedalus::core::kernels::VectorOperation operation,
+	const double* left,
+	const double* right,
+	double* out,
+	size_t size
+) {
+	dispatch(operation, Array{ left }, Array{ right }, out, size);
+}
+
+void daedalus::core::kernels::apply_scalar(
+	daedalus::core::kernels::VectorOperation operation,
+	const double* vector,
+	double scalar,
+	bool scalarOnLeft,
+	double* out,
+	size_t size
+) {
+	if(scalarOnLeft) {
+		dispatch(operation, Broadcast{ scalar }, Array{ vector }, out, size);
+	} else {
+		dispatch(operation, Array{ vector }, Broadcast{ scalar }, out, size);
+	}
+}
+
+double daedalus::core::kernels::reduce(
+	daedalus::core::kernels::VectorReduction reduction,
+	const double* vector,
+	size_t size
+) {
+	switch(reduction) {
+		case daedalus::core::kernels::VectorReduction::SUM:
+			return run_reduce<Add>(vector, size, 0);
+		case daedalus::core::kernels::VectorReduction::MIN:
+			return run_reduce<Min>(vector, size, std::numeric_limits<double>::infinity());
+		case daedalus::core::kernels::VectorReduction::MAX:
+			return run_reduce<Max>(vector, size, -std::numeric_limits<double>::infinity());
+	}
+	return 0;
+}
+
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::kernels::apply_vector_operation(
+	daedalus::core::kernels::VectorOperation operation,
+	std::shared_ptr<daedalus::core::values::RuntimeValue> left,
+	std::shared_ptr<daedalus::core::values::RuntimeValue> right
+) {
+	auto leftVector = std::dynamic_pointer_cast<daedalus::core::values::NumberVectorValue>(left);
+	auto rightVector = std::dynamic_pointer_cast<daedalus::core::values::NumberVectorValue>(right);
+
+	if(leftVector == nullptr && rightVector == nullptr) {
+		return nullptr;
+	}
+
+	if(leftVector != nullptr && rightVector != nullptr) {
+		DAE_ASSERT_TRUE(
+			leftVector->size() == rightVector->size(),
+			std::runtime_error("Vector size mismatch (" + std::to_string(leftVector->size()) + " and " + std::to_string(rightVector->size()) + ")")
+		)
+		auto result = daedalus::core::values::make_value<daedalus::core::values::NumberVectorValue>(leftVector->size());
+		daedalus::core::kernels::apply(operation, leftVector->get().data(), rightVector->get().data(), result->get().data(), result->size());
+		return result;
+	}
+
+	bool scalarOnLeft = leftVector == nullptr;
+	auto vector = scalarOnLeft ? rightVector : leftVector;
+	auto scalar = std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(scalarOnLeft ? left : right);
+
+	DAE_ASSERT_TRUE(
+		scalar != nullptr,
+		std::runtime_error("Trying to apply a vector operation on " + (scalarOnLeft ? left : right)->type())
+	)
+
+	auto result = daedalus::core::values::make_value<daedalus::core::values::NumberVectorValue>(vector->size());
+	daedalus::core::kernels::apply_scalar(operation, vector->get().data(), scalar->get(), scalarOnLeft, result->get().data(), result->size());
+	return result;
+}
+
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::kernels::apply_vector_reduction(
+	daedalus::core::kernels::VectorReduction reduction,
+	std::shared_ptr<daedalus::core::values::RuntimeValue> vector
+) {
+	auto numberVector = std::dynamic_pointer_cast<daedalus::core::values::NumberVectorValue>(vector);
+	if(numberVector == nullptr) {
+		return nullptr;
+	}
+	return daedalus::core::values::make_value<daedalus::core::values::NumberValue>(
+		daedalus::core::kernels::reduce(reduction, numberVector->get().data(), numberVector->size())
+	);
+}
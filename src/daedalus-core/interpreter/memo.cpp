@@ -0,0 +1,228 @@
+#include <daedalus/core/interpreter/memo.hpp>
+#include <daedalus/core/interpreter/effects.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+	/**
+	 * Number of analyzed nodes from which the analyses of freed nodes are dropped
+	 */
+	const size_t MIN_PRUNED_NODES = 256;
+
+	/**
+	 * Remove a single entry from a multimap index
+	 */
+	template<typename Map, typename Key, typename Iterator>
+	void unindex(Map& map, const Key& key, Iterator entry) {
+		auto [begin, end] = map.equal_range(key);
+		for(auto indexed = begin; indexed != end; indexed++) {
+			if(indexed->second == entry) {
+				map.erase(indexed);
+				return;
+			}
+		}
+	}
+}
+
+double daedalus::core::interpreter::hit_rate(const daedalus::core::interpreter::MemoCacheStats& stats) {
+	size_t lookups = stats.hits + stats.misses;
+	return lookups == 0 ? 0 : static_cast<double>(stats.hits) / lookups;
+}
+
+daedalus::core::interpreter::MemoCache::MemoCache(daedalus::core::interpreter::MemoCacheOptions options) :
+	options(options),
+	pruneNodesAt(MIN_PRUNED_NODES),
+	stats(daedalus::core::interpreter::MemoCacheStats{ 0, 0, 0, 0, 0 })
+{}
+
+daedalus::core::interpreter::RuntimeValueWrapper daedalus::core::interpreter::MemoCache::evaluate(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	std::shared_ptr<daedalus::core::ast::Statement> statement,
+	std::shared_ptr<daedalus::core::env::Environment> env,
+	const daedalus::core::interpreter::ParseStatementFunction& evaluate
+) {
+	bool cacheable = false;
+	std::vector<std::string> reads;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		NodeInfo& info = this->get_node_info(interpreter, statement);
+		cacheable = info.cacheable && this->options.maxEntries != 0;
+		reads = info.reads;
+	}
+	if(!cacheable) {
+		return evaluate(interpreter, statement, env);
+	}
+
+	// * Key, the errors of undeclared keys being left to the evaluation function
+
+	std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> arguments;
+	std::vector<size_t> argumentHashes;
+	size_t hash = std::hash<const void*>()(statement.get());
+	try {
+		for(const std::string& key : reads) {
+			arguments.push_back(env->get_value(key));
+			argumentHashes.push_back(arguments.back()->hash());
+			hash = daedalus::core::ast::hash_combine(hash, argumentHashes.back());
+		}
+	} catch(const std::exception&) {
+		return evaluate(interpreter, statement, env);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		auto entry = this->find(statement, arguments, argumentHashes, hash);
+		if(entry != this->entries.end()) {
+			this->stats.hits++;
+			this->entries.splice(this->entries.begin(), this->entries, entry);
+			return entry->result;
+		}
+		this->stats.misses++;
+	}
+
+	daedalus::core::interpreter::RuntimeValueWrapper result = evaluate(interpreter, statement, env);
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	// Another thread may have cached it meanwhile, or the cache been cleared
+	if(this->find(statement, arguments, argumentHashes, hash) != this->entries.end() || this->nodes.find(statement.get()) == this->nodes.end()) {
+		return result;
+	}
+
+	this->entries.push_front(Entry{
+		statement,
+		std::move(arguments),
+		std::move(argumentHashes),
+		hash,
+		result
+	});
+	this->entriesByHash.emplace(hash, this->entries.begin());
+	for(const std::string& key : reads) {
+		this->entriesByKey.emplace(key, this->entries.begin());
+	}
+
+	while(this->entries.size() > this->options.maxEntries) {
+		this->erase(std::prev(this->entries.end()));
+		this->stats.evictions++;
+	}
+
+	return result;
+}
+
+void daedalus::core::interpreter::MemoCache::watch(std::shared_ptr<daedalus::core::env::Environment> env) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	this->watched.erase(
+		std::remove_if(this->watched.begin(), this->watched.end(), [] (const std::weak_ptr<daedalus::core::env::Environment>& watched) {
+			return watched.expired();
+		}),
+		this->watched.end()
+	);
+	for(const std::weak_ptr<daedalus::core::env::Environment>& watched : this->watched) {
+		if(watched.lock() == env) {
+			return;
+		}
+	}
+	this->watched.push_back(env);
+
+	std::weak_ptr<MemoCache> cache = this->weak_from_this();
+	env->add_listener([cache] (const std::string& key, const std::shared_ptr<daedalus::core::values::RuntimeValue>& value) {
+		if(std::shared_ptr<MemoCache> alive = cache.lock()) {
+			alive->invalidate(key);
+		}
+	});
+}
+
+void daedalus::core::interpreter::MemoCache::invalidate(const std::string& key) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	auto [begin, end] = this->entriesByKey.equal_range(key);
+	std::vector<std::list<Entry>::iterator> invalidated;
+	for(auto indexed = begin; indexed != end; indexed++) {
+		invalidated.push_back(indexed->second);
+	}
+	for(std::list<Entry>::iterator entry : invalidated) {
+		this->erase(entry);
+		this->stats.invalidations++;
+	}
+}
+
+void daedalus::core::interpreter::MemoCache::clear() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->entries.clear();
+	this->entriesByHash.clear();
+	this->entriesByKey.clear();
+	this->nodes.clear();
+	this->pruneNodesAt = MIN_PRUNED_NODES;
+}
+
+daedalus::core::interpreter::MemoCacheStats daedalus::core::interpreter::MemoCache::get_stats() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	daedalus::core::interpreter::MemoCacheStats stats = this->stats;
+	stats.entries = this->entries.size();
+	return stats;
+}
+
+daedalus::core::interpreter::MemoCache::NodeInfo& daedalus::core::interpreter::MemoCache::get_node_info(
+	daedalus::core::interpreter::Interpreter& interpreter,
+	const std::shared_ptr<daedalus::core::ast::Statement>& statement
+) {
+	auto info = this->nodes.find(statement.get());
+	if(info != this->nodes.end()) {
+		if(!info->second.node.expired()) {
+			return info->second;
+		}
+		// The analyzed node was freed, its address being reused by this one
+		this->nodes.erase(info);
+	}
+
+	// Nodes with cached results are kept alive by their entries, the others are only known weakly
+	if(this->nodes.size() >= this->pruneNodesAt) {
+		for(auto node = this->nodes.begin(); node != this->nodes.end();) {
+			node = node->second.node.expired() ? this->nodes.erase(node) : std::next(node);
+		}
+		this->pruneNodesAt = std::max(MIN_PRUNED_NODES, this->nodes.size() * 2);
+	}
+
+	daedalus::core::interpreter::StatementEffects effects = daedalus::core::interpreter::analyze_effects(interpreter, statement);
+	return this->nodes.emplace(statement.get(), NodeInfo{
+		statement,
+		effects.pure && effects.writes.empty(),
+		effects.reads
+	}).first->second;
+}
+
+std::list<daedalus::core::interpreter::MemoCache::Entry>::iterator daedalus::core::interpreter::MemoCache::find(
+	const std::shared_ptr<daedalus::core::ast::Statement>& statement,
+	const std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>>& arguments,
+	const std::vector<size_t>& argumentHashes,
+	size_t hash
+) {
+	auto [begin, end] = this->entriesByHash.equal_range(hash);
+	for(auto indexed = begin; indexed != end; indexed++) {
+		Entry& entry = *indexed->second;
+		if(entry.node != statement || entry.argumentHashes != argumentHashes) {
+			continue;
+		}
+
+		bool equal = true;
+		for(size_t i = 0; equal && i < arguments.size(); i++) {
+			// A cached argument changed in place does not hash the same anymore
+			equal = entry.arguments[i]->hash() == entry.argumentHashes[i] && entry.arguments[i]->equals(arguments[i]);
+		}
+		if(equal) {
+			return indexed->second;
+		}
+	}
+	return this->entries.end();
+}
+
+void daedalus::core::interpreter::MemoCache::erase(std::list<Entry>::iterator entry) {
+	unindex(this->entriesByHash, entry->hash, entry);
+	auto info = this->nodes.find(entry->node.get());
+	if(info != this->nodes.end()) {
+		for(const std::string& key : info->second.reads) {
+			unindex(this->entriesByKey, key, entry);
+		}
+	}
+	this->entries.erase(entry);
+}
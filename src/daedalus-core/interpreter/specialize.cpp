@@ -0,0 +1,105 @@
+#include <daedalus/core/interpreter/specialize.hpp>
+
+namespace {
+	bool guards_pass(
+		const daedalus::core::interpreter::Specialization& specialization,
+		const std::shared_ptr<daedalus::core::values::RuntimeValue>* operands,
+		size_t count
+	) {
+		for(size_t i = 0; i < count; i++) {
+			if(operands[i] == nullptr || std::type_index(typeid(*operands[i])) != specialization.operandTypes[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+daedalus::core::interpreter::CompiledStatement daedalus::core::interpreter::make_specializing_node(
+	std::vector<daedalus::core::interpreter::CompiledStatement> operands,
+	daedalus::core::interpreter::OperandsFunction generic,
+	std::vector<daedalus::core::interpreter::Specialization> specializations,
+	daedalus::core::interpreter::SpecializationOptions options,
+	std::shared_ptr<daedalus::core::interpreter::SpecializationFeedback> feedback
+) {
+	DAE_ASSERT_TRUE(
+		operands.size() <= DAE_SPECIALIZATION_MAX_OPERANDS,
+		std::runtime_error("Specializing nodes can have at most " + std::to_string(DAE_SPECIALIZATION_MAX_OPERANDS) + " operands")
+	)
+	for(const daedalus::core::interpreter::Specialization& specialization : specializations) {
+		DAE_ASSERT_TRUE(
+			specialization.operandTypes.size() == operands.size(),
+			std::runtime_error("Specialization expects " + std::to_string(specialization.operandTypes.size()) + " operands, node has " + std::to_string(operands.size()))
+		)
+	}
+
+	if(feedback == nullptr) {
+		feedback = std::make_shared<daedalus::core::interpreter::SpecializationFeedback>();
+	}
+
+	return [operands, generic, specializations, options, feedback] (
+		daedalus::core::interpreter::Interpreter& interpreter,
+		const std::shared_ptr<daedalus::core::env::Environment>& env
+	) -> daedalus::core::interpreter::RuntimeValueWrapper {
+		std::shared_ptr<daedalus::core::values::RuntimeValue> values[DAE_SPECIALIZATION_MAX_OPERANDS];
+		for(size_t i = 0; i < operands.size(); i++) {
+			values[i] = operands[i](interpreter, env).value;
+		}
+
+		int active = feedback->active.load(std::memory_order_relaxed);
+
+		if(active >= 0) {
+			const daedalus::core::interpreter::Specialization& specialization = specializations[active];
+			if(guards_pass(specialization, values, operands.size())) {
+				return specialization.fastPath(interpreter, values);
+			}
+
+			// * Deoptimize
+
+			size_t deoptimizations = feedback->deoptimizations.fetch_add(1, std::memory_order_relaxed) + 1;
+			feedback->candidate.store(-1, std::memory_order_relaxed);
+			feedback->streak.store(0, std::memory_order_relaxed);
+			feedback->active.store(deoptimizations >= options.maxDeoptimizations ? -2 : -1, std::memory_order_relaxed);
+		} else if(active == -1) {
+
+			// * Record the observed types
+
+			int observed = -1;
+			for(size_t i = 0; i < specializations.size(); i++) {
+				if(guards_pass(specializations[i], values, operands.size())) {
+					observed = static_cast<int>(i);
+					break;
+				}
+			}
+
+			if(observed >= 0 && observed == feedback->candidate.load(std::memory_order_relaxed)) {
+				if(feedback->streak.fetch_add(1, std::memory_order_relaxed) + 1 >= options.warmup) {
+					feedback->active.store(observed, std::memory_order_relaxed);
+				}
+			} else {
+				feedback->candidate.store(observed, std::memory_order_relaxed);
+				feedback->streak.store(observed >= 0 ? 1 : 0, std::memory_order_relaxed);
+			}
+		}
+
+		return generic(interpreter, values);
+	};
+}
+
+daedalus::core::interpreter::Specialization daedalus::core::interpreter::make_number_specialization(double (*operation)(double, double)) {
+	return daedalus::core::interpreter::Specialization{
+		std::vector<std::type_index>({
+			std::type_index(typeid(daedalus::core::values::NumberValue)),
+			std::type_index(typeid(daedalus::core::values::NumberValue))
+		}),
+		[operation] (
+			daedalus::core::interpreter::Interpreter& interpreter,
+			const std::shared_ptr<daedalus::core::values::RuntimeValue>* operands
+		) -> daedalus::core::interpreter::RuntimeValueWrapper {
+			return daedalus::core::interpreter::wrap(daedalus::core::values::make_value<daedalus::core::values::NumberValue>(operation(
+				static_cast<daedalus::core::values::NumberValue*>(operands[0].get())->get(),
+				static_cast<daedalus::core::values::NumberValue*>(operands[1].get())->get()
+			)));
+		}
+	};
+}
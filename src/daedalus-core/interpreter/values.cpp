@@ -1,4 +1,9 @@
 #include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <daedalus/core/parser/ast.hpp>
+
+#include <functional>
+#include <stdexcept>
 
 #pragma region RuntimeValue
 
@@ -11,6 +16,15 @@ std::string daedalus::core::values::RuntimeValue::repr() {
 bool daedalus::core::values::RuntimeValue::IsTrue() {
 	return false;
 }
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::values::RuntimeValue::copy() {
+	throw std::runtime_error("Cannot copy value of type " + this->type());
+}
+size_t daedalus::core::values::RuntimeValue::hash() {
+	return std::hash<const void*>()(this);
+}
+bool daedalus::core::values::RuntimeValue::equals(const std::shared_ptr<daedalus::core::values::RuntimeValue>& other) {
+	return other.get() == this;
+}
 
 #pragma endregion
 
@@ -26,6 +40,15 @@ std::string daedalus::core::values::NullValue::repr() {
 bool daedalus::core::values::NullValue::IsTrue() {
 	return false;
 }
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::values::NullValue::copy() {
+	return daedalus::core::values::null_value();
+}
+size_t daedalus::core::values::NullValue::hash() {
+	return 0;
+}
+bool daedalus::core::values::NullValue::equals(const std::shared_ptr<daedalus::core::values::RuntimeValue>& other) {
+	return std::dynamic_pointer_cast<daedalus::core::values::NullValue>(other) != nullptr;
+}
 
 daedalus::core::values::NumberValue::NumberValue(double value) :
 	value(value)
@@ -43,5 +66,61 @@ std::string daedalus::core::values::NumberValue::repr() {
 bool daedalus::core::values::NumberValue::IsTrue() {
 	return this->value != 0;
 }
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::values::NumberValue::copy() {
+	return daedalus::core::values::make_value<daedalus::core::values::NumberValue>(this->value);
+}
+size_t daedalus::core::values::NumberValue::hash() {
+	// `0.0` and `-0.0` compare equal, they must hash the same
+	return std::hash<double>()(this->value == 0 ? 0 : this->value);
+}
+bool daedalus::core::values::NumberValue::equals(const std::shared_ptr<daedalus::core::values::RuntimeValue>& other) {
+	auto number = std::dynamic_pointer_cast<daedalus::core::values::NumberValue>(other);
+	return number != nullptr && number->value == this->value;
+}
+
+#pragma endregion
+
+#pragma region NumberVectorValue
+
+daedalus::core::values::NumberVectorValue::NumberVectorValue(size_t size, double fill) :
+	values(size, fill)
+{}
+daedalus::core::values::NumberVectorValue::NumberVectorValue(daedalus::core::values::NumberVectorValue::Storage values) :
+	values(std::move(values))
+{}
+
+daedalus::core::values::NumberVectorValue::Storage& daedalus::core::values::NumberVectorValue::get() {
+	return this->values;
+}
+size_t daedalus::core::values::NumberVectorValue::size() {
+	return this->values.size();
+}
+std::string daedalus::core::values::NumberVectorValue::type() {
+	return "NumberVectorValue";
+}
+std::string daedalus::core::values::NumberVectorValue::repr() {
+	std::string pretty = "[";
+	for(size_t i = 0; i < this->values.size(); i++) {
+		pretty += (i == 0 ? "" : ", ") + std::to_string(this->values[i]);
+	}
+	return pretty + "]";
+}
+bool daedalus::core::values::NumberVectorValue::IsTrue() {
+	return !this->values.empty();
+}
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::values::NumberVectorValue::copy() {
+	return daedalus::core::values::make_value<daedalus::core::values::NumberVectorValue>(this->values);
+}
+size_t daedalus::core::values::NumberVectorValue::hash() {
+	size_t hash = std::hash<size_t>()(this->values.size());
+	for(double value : this->values) {
+		hash = daedalus::core::ast::hash_combine(hash, std::hash<double>()(value == 0 ? 0 : value));
+	}
+	return hash;
+}
+bool daedalus::core::values::NumberVectorValue::equals(const std::shared_ptr<daedalus::core::values::RuntimeValue>& other) {
+	auto vector = std::dynamic_pointer_cast<daedalus::core::values::NumberVectorValue>(other);
+	return vector != nullptr && vector->values == this->values;
+}
 
 #pragma endregion
@@ -1,5 +1,193 @@
 #include <daedalus/core/lexer/lexer.hpp>
 
+#include <cctype>
+#include <charconv>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+	typedef struct InternTable {
+		std::mutex mutex;
+		std::unordered_map<std::string, uint32_t> ids;
+		/**
+		 * The interned strings, a deque keeping references stable while growing
+		 */
+		std::deque<std::string> strings;
+	} InternTable;
+
+	InternTable& intern_table() {
+		static InternTable table;
+		return table;
+	}
+
+	size_t skip_digits(std::string_view src, size_t i) {
+		while(i < src.length() && std::isdigit(static_cast<unsigned char>(src[i]))) {
+			i++;
+		}
+		return i;
+	}
+
+	size_t lex_number(
+		const daedalus::core::lexer::Lexer& lexer,
+		std::string_view src,
+		daedalus::core::lexer::TokenPayload& payload
+	) {
+		size_t length = skip_digits(src, 0);
+		if(length == 0) {
+			return 0;
+		}
+
+		bool integer = true;
+		bool negativeExponent = false;
+
+		if(length + 1 < src.length() && src[length] == lexer.decimalSeparator && std::isdigit(static_cast<unsigned char>(src[length + 1]))) {
+			integer = false;
+			length = skip_digits(src, length + 1);
+		}
+
+		if(length < src.length() && (src[length] == 'e' || src[length] == 'E')) {
+			size_t exponent = length + 1;
+			if(exponent < src.length() && (src[exponent] == '+' || src[exponent] == '-')) {
+				negativeExponent = src[exponent] == '-';
+				exponent++;
+			}
+			if(exponent < src.length() && std::isdigit(static_cast<unsigned char>(src[exponent]))) {
+				integer = false;
+				length = skip_digits(src, exponent);
+			}
+		}
+
+		if(integer) {
+			int64_t value = 0;
+			if(std::from_chars(src.data(), src.data() + length, value).ec == std::errc()) {
+				payload = value;
+				return length;
+			}
+		}
+
+		// `from_chars` only reads `.` as the decimal separator
+		std::string text = std::string(src.substr(0, length));
+		if(lexer.decimalSeparator != '.') {
+			std::replace(text.begin(), text.end(), lexer.decimalSeparator, '.');
+		}
+
+		double value = 0;
+		if(std::from_chars(text.data(), text.data() + text.length(), value).ec == std::errc::result_out_of_range) {
+			value = negativeExponent ? 0 : std::numeric_limits<double>::infinity();
+		}
+		payload = value;
+		return length;
+	}
+
+	/**
+	 * Get a function lexing a fixed value, checked against the source in place
+	 */
+	std::function<size_t (const daedalus::core::lexer::Lexer&, std::string_view, daedalus::core::lexer::TokenPayload&)> lex_prefix(std::string value) {
+		return [value] (const daedalus::core::lexer::Lexer& lexer, std::string_view src, daedalus::core::lexer::TokenPayload& payload) -> size_t {
+			return src.substr(0, value.length()) == value ? value.length() : 0;
+		};
+	}
+
+	bool starts_at(const std::string& src, size_t cursor, const std::string& prefix) {
+		return !prefix.empty() && src.compare(cursor, prefix.length(), prefix) == 0;
+	}
+
+	/**
+	 * Lex a source string with a cursor, the remaining source only being copied for the `lex_token` functions
+	 */
+	daedalus::core::tools::Result<void> lex_source(
+		const daedalus::core::lexer::Lexer& lexer,
+		const daedalus::core::lexer::TokenCallback& onToken,
+		const std::string& src
+	) {
+		size_t cursor = 0;
+
+		while(cursor < src.length()) {
+
+			// * Check for skippable characters
+
+			if(std::find(lexer.whitespaces.begin(), lexer.whitespaces.end(), src[cursor]) != lexer.whitespaces.end()) {
+				cursor++;
+				continue;
+			}
+
+			// * Check for comments
+
+			// Single line
+			if(starts_at(src, cursor, lexer.singleLineComment)) {
+				cursor = std::min(src.find('\n', cursor), src.length());
+				continue;
+			}
+
+			// Multi line open
+			if(starts_at(src, cursor, lexer.multiLineComment.first)) {
+				size_t end = src.find(lexer.multiLineComment.second, cursor + lexer.multiLineComment.first.length());
+				if(end == std::string::npos || lexer.multiLineComment.second.empty()) {
+					return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNCLOSED_COMMENT, cursor };
+				}
+				cursor = end + lexer.multiLineComment.second.length();
+				continue;
+			}
+			if(starts_at(src, cursor, lexer.multiLineComment.second)) {
+				return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNOPENED_COMMENT, cursor };
+			}
+
+			// * Lex token
+
+			std::string_view rest = std::string_view(src).substr(cursor);
+			daedalus::core::lexer::TokenPayload payload = daedalus::core::lexer::TokenPayload();
+
+			if(lexer.staticMatcher != nullptr) {
+				std::string_view name;
+				size_t length = lexer.staticMatcher(rest, name, payload);
+				if(length != 0) {
+					onToken(daedalus::core::lexer::Token{ std::string(name), std::string(rest.substr(0, length)), payload, cursor });
+					cursor += length;
+					continue;
+				}
+			}
+
+			bool tokenFound = false;
+			std::string remaining = "";
+
+			for(const daedalus::core::lexer::TokenType& tokenType : lexer.tokenTypes) {
+				if(tokenType.lex_typed_token != nullptr) {
+					payload = daedalus::core::lexer::TokenPayload();
+					size_t length = tokenType.lex_typed_token(lexer, rest, payload);
+					if(length != 0) {
+						onToken(daedalus::core::lexer::Token{ tokenType.name, std::string(rest.substr(0, length)), payload, cursor });
+						cursor += length;
+						tokenFound = true;
+						break;
+					}
+					continue;
+				}
+
+				if(remaining.empty()) {
+					remaining = std::string(rest);
+				}
+				std::string tokenValue = tokenType.lex_token(remaining);
+				if(tokenValue.length() != 0) {
+					size_t length = tokenValue.length();
+					onToken(daedalus::core::lexer::Token{ tokenType.name, std::move(tokenValue), daedalus::core::lexer::TokenPayload(), cursor });
+					cursor += length;
+					tokenFound = true;
+					break;
+				}
+			}
+
+			if(!tokenFound) {
+				return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNKNOWN_TOKEN, cursor };
+			}
+		}
+
+		onToken(daedalus::core::lexer::Token{ "EOF", "", daedalus::core::lexer::TokenPayload(), src.length() });
+		return daedalus::core::tools::Result<void>();
+	}
+}
+
 [[nodiscard]] char peek(std::string str) {
 	return str.at(0);
 }
@@ -19,7 +207,7 @@
 	return first;
 }
 
-bool startswith(std::string str, std::string substr) {
+bool startswith(const std::string& str, const std::string& substr) {
 	return str.rfind(substr, 0) == 0;
 }
 
@@ -30,19 +218,11 @@ std::string daedalus::core::lexer::repr(const daedalus::core::lexer::Token& toke
 }
 
 daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::string name) {
-	return daedalus::core::lexer::TokenType{
-		name,
-		[name](std::string src) -> std::string {
-			if(startswith(src, name)) {
-				return name;
-			}
-			return "";
-		}
-	};
+	return daedalus::core::lexer::make_token_type(name, name);
 }
 
 daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::string name, std::string value) {
-	return daedalus::core::lexer::TokenType{
+	daedalus::core::lexer::TokenType tokenType = daedalus::core::lexer::TokenType{
 		name,
 		[value](std::string src) -> std::string {
 			if(startswith(src, value)) {
@@ -51,6 +231,8 @@ daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::str
 			return "";
 		}
 	};
+	tokenType.lex_typed_token = lex_prefix(value);
+	return tokenType;
 }
 
 daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::string name, std::function<std::string(std::string)> lex_token) {
@@ -60,6 +242,88 @@ daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::str
 	};
 }
 
+daedalus::core::lexer::TokenType daedalus::core::lexer::make_token_type(std::string name, std::function<size_t(std::string_view)> lex_token) {
+	daedalus::core::lexer::TokenType tokenType = daedalus::core::lexer::TokenType{
+		name,
+		[lex_token] (std::string src) -> std::string {
+			return src.substr(0, lex_token(src));
+		}
+	};
+	tokenType.lex_typed_token = [lex_token] (const daedalus::core::lexer::Lexer& lexer, std::string_view src, daedalus::core::lexer::TokenPayload& payload) -> size_t {
+		return lex_token(src);
+	};
+	return tokenType;
+}
+
+daedalus::core::lexer::TokenType daedalus::core::lexer::make_number_token_type(std::string name, char decimalSeparator) {
+	daedalus::core::lexer::Lexer lexer;
+	lexer.decimalSeparator = decimalSeparator;
+
+	daedalus::core::lexer::TokenType tokenType = daedalus::core::lexer::TokenType{
+		name,
+		[lexer] (std::string src) -> std::string {
+			daedalus::core::lexer::TokenPayload payload;
+			return src.substr(0, lex_number(lexer, src, payload));
+		}
+	};
+	tokenType.lex_typed_token = &lex_number;
+	return tokenType;
+}
+
+daedalus::core::lexer::TokenType daedalus::core::lexer::make_interned_token_type(std::string name, std::function<std::string(std::string)> lex_token) {
+	daedalus::core::lexer::TokenType tokenType = daedalus::core::lexer::TokenType{
+		name,
+		lex_token
+	};
+	tokenType.lex_typed_token = [lex_token] (const daedalus::core::lexer::Lexer& lexer, std::string_view src, daedalus::core::lexer::TokenPayload& payload) -> size_t {
+		std::string value = lex_token(std::string(src));
+		if(value.length() != 0) {
+			payload = daedalus::core::lexer::intern(value);
+		}
+		return value.length();
+	};
+	return tokenType;
+}
+
+daedalus::core::lexer::TokenType daedalus::core::lexer::make_interned_token_type(std::string name, std::function<size_t(std::string_view)> lex_token) {
+	daedalus::core::lexer::TokenType tokenType = daedalus::core::lexer::make_token_type(name, lex_token);
+	tokenType.lex_typed_token = [lex_token] (const daedalus::core::lexer::Lexer& lexer, std::string_view src, daedalus::core::lexer::TokenPayload& payload) -> size_t {
+		size_t length = lex_token(src);
+		if(length != 0) {
+			payload = daedalus::core::lexer::intern(std::string(src.substr(0, length)));
+		}
+		return length;
+	};
+	return tokenType;
+}
+
+daedalus::core::lexer::InternedString daedalus::core::lexer::intern(const std::string& str) {
+	InternTable& table = intern_table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	auto interned = table.ids.find(str);
+	if(interned != table.ids.end()) {
+		return daedalus::core::lexer::InternedString{ interned->second };
+	}
+
+	uint32_t id = static_cast<uint32_t>(table.strings.size());
+	table.strings.push_back(str);
+	table.ids.emplace(str, id);
+	return daedalus::core::lexer::InternedString{ id };
+}
+
+const std::string& daedalus::core::lexer::get_interned(daedalus::core::lexer::InternedString interned) {
+	InternTable& table = intern_table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	DAE_ASSERT_TRUE(
+		interned.id < table.strings.size(),
+		std::runtime_error("Unknown interned string id " + std::to_string(interned.id))
+	)
+
+	return table.strings[interned.id];
+}
+
 void daedalus::core::lexer::setup_lexer(
 	daedalus::core::lexer::Lexer& lexer,
 	const std::vector<daedalus::core::lexer::TokenType>& tokenTypes,
@@ -86,71 +350,38 @@ void daedalus::core::lexer::lex(
 	std::vector<daedalus::core::lexer::Token>& tokens,
 	std::string src
 ) {
-	while(src.length() > 0) {
-
-		// * Check for skippable characters
-
-		try {
-            while(std::find(lexer.whitespaces.begin(), lexer.whitespaces.end(), peek(src)) != lexer.whitespaces.end()) {
-    			(void)shift(src);
-    		}
-		} catch(const std::exception& e) {
-		    break;
-		}
-
-		// * Check for comments
-
-		// Single line
-		if(startswith(src, lexer.singleLineComment)) {
-			while(peek(src) != '\n' && src.length() > 0) {
-				(void)shift(src);
-			}
-			continue;
-		}
+	daedalus::core::lexer::lex_stream(
+		lexer,
+		[&tokens] (daedalus::core::lexer::Token token) {
+			tokens.push_back(std::move(token));
+		},
+		std::move(src)
+	);
+}
 
-		// Multi line open
-		if(startswith(src, lexer.multiLineComment.first)) {
-			while(!startswith(src, lexer.multiLineComment.second)) {
-				DAE_ASSERT_TRY(
-					{ (void)shift(src); },
-					std::runtime_error("Comment being opened and not closed before EOF")
-				)
-			}
-			(void)shift(src, lexer.multiLineComment.second.length());
-			continue;
-		}
-		DAE_ASSERT_TRUE(
-			!startswith(src, lexer.multiLineComment.second),
-			std::runtime_error("Comment being closed without being opened")
-		)
-
-		// Lex token
-
-		bool tokenFound = false;
-
-		for(const daedalus::core::lexer::TokenType& tokenType : lexer.tokenTypes) {
-			std::string tokenValue = tokenType.lex_token(src);
-			if(tokenValue.length() != 0) {
-				(void)shift(src, tokenValue.length());
-				tokens.push_back(
-					daedalus::core::lexer::Token{
-						tokenType.name,
-						tokenValue
-					}
-				);
-				tokenFound = true;
-				break;
-			}
-		}
+void daedalus::core::lexer::lex_stream(
+	daedalus::core::lexer::Lexer& lexer,
+	daedalus::core::lexer::TokenCallback onToken,
+	std::string src
+) {
+	daedalus::core::tools::Result<void> result = lex_source(lexer, onToken, src);
 
-		DAE_ASSERT_TRUE(
-			tokenFound,
-			std::runtime_error("Unknown token in \"" + src + "\"")
-		)
-	}
+	DAE_ASSERT_TRUE(
+		result.ok(),
+		std::runtime_error(daedalus::core::tools::format_error(result.error(), src))
+	)
+}
 
-	tokens.push_back(Token{
-		"EOF",
-		""
-	});
+daedalus::core::tools::Result<void> daedalus::core::lexer::try_lex(
+	daedalus::core::lexer::Lexer& lexer,
+	std::vector<daedalus::core::lexer::Token>& tokens,
+	const std::string& src
+) {
+	return lex_source(
+		lexer,
+		[&tokens] (daedalus::core::lexer::Token token) {
+			tokens.push_back(std::move(token));
+		},
+		src
+	);
 }
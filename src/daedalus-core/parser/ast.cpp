@@ -1,4 +1,8 @@
 #include <daedalus/core/parser/ast.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 
 std::string daedalus::core::ast::Statement::type() {
@@ -7,10 +11,32 @@ std::string daedalus::core::ast::Statement::type() {
 std::string daedalus::core::ast::Statement::repr(int indent) {
 	return std::string(indent, '\t') + "Statement";
 }
+std::vector<std::shared_ptr<daedalus::core::ast::Expression>> daedalus::core::ast::Statement::get_children() {
+	return std::vector<std::shared_ptr<daedalus::core::ast::Expression>>();
+}
+bool daedalus::core::ast::Statement::has_hidden_children() {
+	return false;
+}
+size_t daedalus::core::ast::Statement::get_footprint() {
+	return sizeof(daedalus::core::ast::Statement);
+}
 
 std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::ast::Expression::get_constexpr() {
 	return nullptr;
 }
+bool daedalus::core::ast::Expression::is_internable() {
+	return false;
+}
+size_t daedalus::core::ast::Expression::get_structural_hash() {
+	return std::hash<std::string>()(this->type());
+}
+bool daedalus::core::ast::Expression::structurally_equals(const std::shared_ptr<daedalus::core::ast::Expression>& other) {
+	return other.get() == this;
+}
+
+size_t daedalus::core::ast::hash_combine(size_t seed, size_t value) {
+	return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
 
 daedalus::core::ast::Scope::Scope(std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body) :
 	body(body)
@@ -45,9 +71,16 @@ std::string daedalus::core::ast::Scope::repr(int indent) {
 
 	return pretty;
 }
+std::vector<std::shared_ptr<daedalus::core::ast::Expression>> daedalus::core::ast::Scope::get_children() {
+	return this->body;
+}
+size_t daedalus::core::ast::Scope::get_footprint() {
+	return sizeof(daedalus::core::ast::Scope) + this->body.capacity() * sizeof(std::shared_ptr<daedalus::core::ast::Expression>);
+}
 
 daedalus::core::ast::NumberExpression::NumberExpression(double value) :
-	value(value)
+	value(value),
+	constant(daedalus::core::values::make_value<daedalus::core::values::NumberValue>(value))
 {}
 
 double daedalus::core::ast::NumberExpression::get_value() {
@@ -55,6 +88,10 @@ double daedalus::core::ast::NumberExpression::get_value() {
 }
 void daedalus::core::ast::NumberExpression::set_value(double value) {
     this->value = value;
+    this->constant = daedalus::core::values::make_value<daedalus::core::values::NumberValue>(value);
+}
+std::shared_ptr<daedalus::core::values::RuntimeValue> daedalus::core::ast::NumberExpression::get_constant() {
+    return this->constant;
 }
 
 std::string daedalus::core::ast::NumberExpression::type() {
@@ -66,3 +103,19 @@ std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::ast::NumberExpr
 std::string daedalus::core::ast::NumberExpression::repr(int indent) {
 	return std::string(indent, '\t') + "NumberExpression(" + std::to_string(this->value) + ")";
 }
+size_t daedalus::core::ast::NumberExpression::get_footprint() {
+	return sizeof(daedalus::core::ast::NumberExpression);
+}
+bool daedalus::core::ast::NumberExpression::is_internable() {
+	return true;
+}
+size_t daedalus::core::ast::NumberExpression::get_structural_hash() {
+	uint64_t bits = 0;
+	std::memcpy(&bits, &this->value, sizeof(bits));
+	return daedalus::core::ast::hash_combine(daedalus::core::ast::Expression::get_structural_hash(), std::hash<uint64_t>()(bits));
+}
+bool daedalus::core::ast::NumberExpression::structurally_equals(const std::shared_ptr<daedalus::core::ast::Expression>& other) {
+	auto number = std::dynamic_pointer_cast<daedalus::core::ast::NumberExpression>(other);
+	// Compared bitwise, so `0` and `-0` stay apart
+	return number != nullptr && number->type() == this->type() && std::memcmp(&number->value, &this->value, sizeof(this->value)) == 0;
+}
@@ -1,4 +1,10 @@
 #include <daedalus/core/parser/parser.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 
 [[nodiscard]] daedalus::core::lexer::Token peek(std::vector<daedalus::core::lexer::Token>& tokens) {
 	return tokens.front();
@@ -21,6 +27,322 @@
 	return token;
 }
 
+namespace {
+	/**
+	 * Smallest number of nodes a node pool holds before pruning the expired ones
+	 */
+	const size_t MIN_PRUNED_NODES = 256;
+
+	/**
+	 * The configuration captured by the lazy scopes of a `parse` call, copied on the first one
+	 */
+	typedef struct ParserSnapshot {
+		const daedalus::core::parser::Parser* source;
+		std::shared_ptr<const daedalus::core::parser::Parser> snapshot;
+	} ParserSnapshot;
+
+	thread_local ParserSnapshot* currentSnapshot = nullptr;
+
+	/**
+	 * A snapshot slot installed on the calling thread as long as the object lives
+	 * @note Nothing is installed when a slot already exists for the same parser, nested `parse` calls sharing it
+	 */
+	class ParserSnapshotScope {
+	public:
+		ParserSnapshotScope(
+			const daedalus::core::parser::Parser& parser,
+			std::shared_ptr<const daedalus::core::parser::Parser> snapshot = nullptr
+		) :
+			slot(ParserSnapshot{ &parser, std::move(snapshot) }),
+			previous(currentSnapshot),
+			installed(currentSnapshot == nullptr || currentSnapshot->source != &parser)
+		{
+			if(this->installed) {
+				currentSnapshot = &this->slot;
+			}
+		}
+
+		~ParserSnapshotScope() {
+			if(this->installed) {
+				currentSnapshot = this->previous;
+			}
+		}
+
+		ParserSnapshotScope(const ParserSnapshotScope&) = delete;
+		ParserSnapshotScope& operator=(const ParserSnapshotScope&) = delete;
+
+	private:
+		ParserSnapshot slot;
+		ParserSnapshot* previous;
+		bool installed;
+	};
+
+	std::shared_ptr<const daedalus::core::parser::Parser> snapshot_parser(const daedalus::core::parser::Parser& parser) {
+		if(currentSnapshot == nullptr || currentSnapshot->source != &parser) {
+			return std::make_shared<const daedalus::core::parser::Parser>(parser);
+		}
+		if(currentSnapshot->snapshot == nullptr) {
+			currentSnapshot->snapshot = std::make_shared<const daedalus::core::parser::Parser>(parser);
+		}
+		return currentSnapshot->snapshot;
+	}
+
+	/**
+	 * Get the node parsing top-level statements
+	 * @return The node, or `nullptr` if no node is a top node
+	 */
+	const daedalus::core::parser::Node* find_top_node(const daedalus::core::parser::Parser& parser) {
+		for(const auto& [key, node] : parser.nodesRegister) {
+			if(node.isTopNode) {
+				return &node;
+			}
+		}
+		return nullptr;
+	}
+
+	bool is_number_node(const daedalus::core::parser::Node& node) {
+		typedef std::shared_ptr<daedalus::core::ast::Expression> (*ParseNodePointer)(daedalus::core::parser::Parser&, std::vector<daedalus::core::lexer::Token>&, bool);
+		const ParseNodePointer* pointer = node.parse_node.target<ParseNodePointer>();
+		return pointer != nullptr && *pointer == &daedalus::core::parser::parse_number_expression;
+	}
+
+	/**
+	 * Read the value of a number token
+	 * @note Tokens without payload are read exactly by `from_chars` when possible, and as tolerantly as `std::stod`
+	 * otherwise (leading spaces, `+`, hexadecimal, trailing suffixes ignored)
+	 */
+	daedalus::core::tools::Result<double> read_number(
+		const daedalus::core::parser::Parser& parser,
+		const daedalus::core::lexer::Token& token
+	) {
+		// Numbers lexed by `make_number_token_type` already hold their value
+		if(const double* value = std::get_if<double>(&token.payload)) {
+			return *value;
+		}
+		if(const int64_t* value = std::get_if<int64_t>(&token.payload)) {
+			return static_cast<double>(*value);
+		}
+
+		// `from_chars` and `strtod` only read `.` as the decimal separator
+		std::string text = token.value;
+		if(parser.decimalSeparator != '.') {
+			std::replace(text.begin(), text.end(), parser.decimalSeparator, '.');
+		}
+
+		double number = 0;
+		const char* end = text.data() + text.length();
+		auto [pointer, error] = std::from_chars(text.data(), end, number);
+		if(error == std::errc() && pointer == end) {
+			return number;
+		}
+
+		char* stop = nullptr;
+		errno = 0;
+		number = std::strtod(text.c_str(), &stop);
+		if(stop == text.c_str() || errno == ERANGE) {
+			return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::INVALID_NUMBER, token.offset };
+		}
+		return number;
+	}
+
+	/**
+	 * Parse a number expression, without throwing
+	 */
+	daedalus::core::tools::Result<std::shared_ptr<daedalus::core::ast::Expression>> try_parse_number_expression(
+		daedalus::core::parser::Parser& parser,
+		std::vector<daedalus::core::lexer::Token>& tokens
+	) {
+		const daedalus::core::lexer::Token& token = tokens.front();
+		if(token.type != "NUMBER") {
+			return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNKNOWN_NODE, token.offset };
+		}
+
+		daedalus::core::tools::Result<double> number = read_number(parser, token);
+		if(!number.ok()) {
+			return number.error();
+		}
+		(void)eat(tokens);
+
+		return std::shared_ptr<daedalus::core::ast::Expression>(daedalus::core::parser::intern_node(
+			parser,
+			std::make_shared<daedalus::core::ast::NumberExpression>(number.value())
+		));
+	}
+
+	/**
+	 * Fold and intern a parsed top-level expression
+	 */
+	std::shared_ptr<daedalus::core::ast::Expression> finish_expression(
+		daedalus::core::parser::Parser& parser,
+		std::shared_ptr<daedalus::core::ast::Expression> expression
+	) {
+		if(daedalus::core::parser::has_flag(parser, daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR)) {
+			expression = expression->get_constexpr();
+		}
+		return daedalus::core::parser::intern_node(parser, expression);
+	}
+}
+
+daedalus::core::parser::LazyScope::LazyScope(
+	std::shared_ptr<const daedalus::core::parser::Parser> parser,
+	std::vector<daedalus::core::lexer::Token> tokens
+) :
+	parser(std::move(parser)),
+	tokens(std::move(tokens)),
+	resolved(false),
+	optimize(false)
+{}
+
+std::vector<std::shared_ptr<daedalus::core::ast::Expression>> daedalus::core::parser::LazyScope::get_body() {
+	this->resolve();
+	return this->body;
+}
+
+std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::parser::LazyScope::get_constexpr() {
+	// An unresolved body is optimized when resolved
+	this->optimize.store(true, std::memory_order_release);
+	if(this->is_resolved()) {
+		return daedalus::core::ast::Scope::get_constexpr();
+	}
+	return this->shared_from_this();
+}
+
+std::string daedalus::core::parser::LazyScope::repr(int indent) {
+	if(this->is_resolved()) {
+		return daedalus::core::ast::Scope::repr(indent);
+	}
+
+	std::string pretty = std::string(indent, '\t') + "{";
+	for(const daedalus::core::lexer::Token& token : this->tokens) {
+		if(token.type != "EOF") {
+			pretty += " " + token.value;
+		}
+	}
+	return pretty + " }";
+}
+
+std::vector<std::shared_ptr<daedalus::core::ast::Expression>> daedalus::core::parser::LazyScope::get_children() {
+	if(!this->is_resolved()) {
+		return std::vector<std::shared_ptr<daedalus::core::ast::Expression>>();
+	}
+	return this->body;
+}
+
+bool daedalus::core::parser::LazyScope::has_hidden_children() {
+	return !this->is_resolved();
+}
+
+size_t daedalus::core::parser::LazyScope::get_footprint() {
+	if(this->is_resolved()) {
+		return sizeof(daedalus::core::parser::LazyScope) + this->body.capacity() * sizeof(std::shared_ptr<daedalus::core::ast::Expression>);
+	}
+	return sizeof(daedalus::core::parser::LazyScope) + this->tokens.capacity() * sizeof(daedalus::core::lexer::Token);
+}
+
+bool daedalus::core::parser::LazyScope::is_resolved() {
+	return this->resolved.load(std::memory_order_acquire);
+}
+
+void daedalus::core::parser::LazyScope::resolve() {
+	std::call_once(this->resolveFlag, [this] () {
+		// Parsed into a copy, so a failed resolution can be retried
+		std::vector<daedalus::core::lexer::Token> tokens = this->tokens;
+		// The AST outlives the run resolving it, its constants must not come from the run's region
+		daedalus::core::values::RegionScope suspended(nullptr);
+		// Node parsing functions take a mutable parser, they get a copy of the snapshot, nested scopes sharing the snapshot
+		daedalus::core::parser::Parser parser = *this->parser;
+		ParserSnapshotScope snapshotScope(parser, this->parser);
+		auto scope = std::make_shared<daedalus::core::ast::Scope>();
+		daedalus::core::parser::parse(parser, scope, tokens);
+
+		std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body = scope->get_body();
+		if(this->optimize.load(std::memory_order_acquire) && !daedalus::core::parser::has_flag(parser, daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR)) {
+			for(std::shared_ptr<daedalus::core::ast::Expression>& expression : body) {
+				expression = expression->get_constexpr();
+			}
+		}
+
+		this->body = body;
+		this->tokens.clear();
+		this->tokens.shrink_to_fit();
+		this->resolved.store(true, std::memory_order_release);
+	});
+}
+
+daedalus::core::parser::NodePool::NodePool() :
+	pruneAt(MIN_PRUNED_NODES),
+	stats(daedalus::core::parser::NodePoolStats{ 0, 0, 0 })
+{}
+
+std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::parser::NodePool::intern(std::shared_ptr<daedalus::core::ast::Expression> node) {
+	if(node == nullptr || !node->is_internable()) {
+		return node;
+	}
+
+	size_t hash = node->get_structural_hash();
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->stats.lookups++;
+
+	auto [begin, end] = this->nodes.equal_range(hash);
+	for(auto candidate = begin; candidate != end;) {
+		std::shared_ptr<daedalus::core::ast::Expression> pooled = candidate->second.lock();
+		if(pooled == nullptr) {
+			candidate = this->nodes.erase(candidate);
+			continue;
+		}
+		if(pooled->structurally_equals(node)) {
+			this->stats.hits++;
+			return pooled;
+		}
+		candidate++;
+	}
+
+	this->nodes.emplace(hash, node);
+
+	// Nodes that are never looked up again would otherwise keep their expired entry
+	if(this->nodes.size() >= this->pruneAt) {
+		for(auto pooled = this->nodes.begin(); pooled != this->nodes.end();) {
+			pooled = pooled->second.expired() ? this->nodes.erase(pooled) : std::next(pooled);
+		}
+		this->pruneAt = std::max(MIN_PRUNED_NODES, this->nodes.size() * 2);
+	}
+
+	return node;
+}
+
+daedalus::core::parser::NodePoolStats daedalus::core::parser::NodePool::get_stats() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	daedalus::core::parser::NodePoolStats stats = this->stats;
+	stats.entries = this->nodes.size();
+	return stats;
+}
+
+void daedalus::core::parser::NodePool::clear() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->nodes.clear();
+	this->pruneAt = MIN_PRUNED_NODES;
+}
+
+std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::parser::intern_node(
+	daedalus::core::parser::Parser& parser,
+	std::shared_ptr<daedalus::core::ast::Expression> node
+) {
+	if(!daedalus::core::parser::has_flag(parser, daedalus::core::parser::ParserFlags::INTERN_NODES)) {
+		return node;
+	}
+	return daedalus::core::parser::get_node_pool(parser)->intern(node);
+}
+
+std::shared_ptr<daedalus::core::parser::NodePool> daedalus::core::parser::get_node_pool(daedalus::core::parser::Parser& parser) {
+	// Parsers are shared by the threads of batch compilations and program caches, the first one creating the pool
+	std::shared_ptr<daedalus::core::parser::NodePool> pool = std::atomic_load(&parser.nodePool);
+	if(pool == nullptr) {
+		std::shared_ptr<daedalus::core::parser::NodePool> created = std::make_shared<daedalus::core::parser::NodePool>();
+		pool = std::atomic_compare_exchange_strong(&parser.nodePool, &pool, created) ? created : pool;
+	}
+	return pool;
+}
+
 daedalus::core::parser::Node daedalus::core::parser::make_node(
 	daedalus::core::parser::ParseNodeFunction parse_node,
 	bool isTopNode
@@ -39,11 +361,70 @@ void daedalus::core::parser::demoteTopNode(
 }
 
 std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::parser::parse_number_expression(daedalus::core::parser::Parser& parser, std::vector<daedalus::core::lexer::Token>& tokens, bool needsSemicolon) {
-	return std::make_shared<daedalus::core::ast::NumberExpression>(std::stod(expect(
-		tokens,
-		"NUMBER",
+	daedalus::core::tools::Result<std::shared_ptr<daedalus::core::ast::Expression>> expression = try_parse_number_expression(parser, tokens);
+
+	DAE_ASSERT_TRUE(
+		expression.ok() || expression.error().code != daedalus::core::tools::ErrorCode::UNKNOWN_NODE,
 		std::runtime_error("Unknown token found (type: " + peek(tokens).type + ", value: " + peek(tokens).value + ")")
-	).value));
+	)
+	DAE_ASSERT_TRUE(
+		expression.ok(),
+		std::runtime_error(daedalus::core::tools::format_error(expression.error()))
+	)
+
+	return expression.value();
+}
+
+std::shared_ptr<daedalus::core::ast::Scope> daedalus::core::parser::parse_scope(
+	daedalus::core::parser::Parser& parser,
+	std::vector<daedalus::core::lexer::Token>& tokens,
+	std::string opener,
+	std::string closer
+) {
+	daedalus::core::lexer::Token open = expect(
+		tokens,
+		opener,
+		std::runtime_error("Expected " + opener + " (type: " + peek(tokens).type + ", value: " + peek(tokens).value + ")")
+	);
+
+	if(!daedalus::core::parser::has_flag(parser, daedalus::core::parser::ParserFlags::LAZY_SCOPES)) {
+		auto scope = std::make_shared<daedalus::core::ast::Scope>();
+		while(peek(tokens).type != closer) {
+			DAE_ASSERT_TRUE(
+				peek(tokens).type != "EOF",
+				std::runtime_error("Scope opened at offset " + std::to_string(open.offset) + " is not closed before EOF")
+			)
+			scope->push_back_body(daedalus::core::parser::parse_expression(parser, tokens, true));
+		}
+		(void)eat(tokens);
+		return scope;
+	}
+
+	// * Brace-match, the tokens being moved out at once
+
+	size_t depth = 1;
+	size_t end = 0;
+	for(; end < tokens.size(); end++) {
+		if(tokens[end].type == opener) {
+			depth++;
+		} else if(tokens[end].type == closer && --depth == 0) {
+			break;
+		}
+	}
+
+	DAE_ASSERT_TRUE(
+		end < tokens.size(),
+		std::runtime_error("Scope opened at offset " + std::to_string(open.offset) + " is not closed before EOF")
+	)
+
+	std::vector<daedalus::core::lexer::Token> body(
+		std::make_move_iterator(tokens.begin()),
+		std::make_move_iterator(tokens.begin() + end)
+	);
+	body.push_back(daedalus::core::lexer::Token{ "EOF", "", daedalus::core::lexer::TokenPayload(), tokens[end].offset });
+	tokens.erase(tokens.begin(), tokens.begin() + end + 1);
+
+	return std::make_shared<daedalus::core::parser::LazyScope>(snapshot_parser(parser), std::move(body));
 }
 
 void daedalus::core::parser::register_node(
@@ -84,19 +465,14 @@ std::shared_ptr<daedalus::core::ast::Expression> daedalus::core::parser::parse_e
 	std::vector<daedalus::core::lexer::Token>& tokens,
 	bool needsSemicolon
 ) {
-	std::shared_ptr<daedalus::core::ast::Expression> expression = nullptr;
+	const daedalus::core::parser::Node* node = find_top_node(parser);
 
-	for(auto& [key, node] : parser.nodesRegister) {
-		if(node.isTopNode) {
-			expression = node.parse_node(parser, tokens, needsSemicolon);
-			if(!has_flag(parser, daedalus::core::parser::ParserFlags::OPTI_CONST_EXPR)) {
-				return expression;
-			}
-			return expression->get_constexpr();
-		}
-	}
+	DAE_ASSERT_TRUE(
+		node != nullptr,
+		std::runtime_error("Unknown token found (type: " + peek(tokens).type + ", value: " + peek(tokens).value + ")")
+	)
 
-	throw std::runtime_error("Unknown token found (type: " + peek(tokens).type + ", value: " + peek(tokens).value + ")");
+	return finish_expression(parser, node->parse_node(parser, tokens, needsSemicolon));
 }
 
 void daedalus::core::parser::parse(
@@ -104,9 +480,49 @@ void daedalus::core::parser::parse(
 	std::shared_ptr<daedalus::core::ast::Scope> program,
 	std::vector<daedalus::core::lexer::Token>& tokens
 ) {
+	ParserSnapshotScope snapshotScope(parser);
 	while(peek(tokens).type != "EOF") {
 		program->push_back_body(
 			parse_expression(parser, tokens, true)
 		);
 	}
 }
+
+daedalus::core::tools::Result<void> daedalus::core::parser::try_parse(
+	daedalus::core::parser::Parser& parser,
+	std::shared_ptr<daedalus::core::ast::Scope> program,
+	std::vector<daedalus::core::lexer::Token>& tokens
+) {
+	const daedalus::core::parser::Node* node = find_top_node(parser);
+
+	ParserSnapshotScope snapshotScope(parser);
+	while(!tokens.empty() && tokens.front().type != "EOF") {
+		if(node == nullptr) {
+			return daedalus::core::tools::Error{ daedalus::core::tools::ErrorCode::UNKNOWN_NODE, tokens.front().offset };
+		}
+
+		// The built-in node reports its errors without throwing, only the language's nodes need catching
+		if(is_number_node(*node)) {
+			daedalus::core::tools::Result<std::shared_ptr<daedalus::core::ast::Expression>> expression = try_parse_number_expression(parser, tokens);
+			if(!expression.ok()) {
+				return expression.error();
+			}
+			program->push_back_body(finish_expression(parser, expression.value()));
+			continue;
+		}
+
+		try {
+			program->push_back_body(
+				finish_expression(parser, node->parse_node(parser, tokens, true))
+			);
+		} catch(const std::exception& e) {
+			return daedalus::core::tools::Error{
+				daedalus::core::tools::ErrorCode::PARSE_ERROR,
+				tokens.empty() ? 0 : tokens.front().offset,
+				e.what()
+			};
+		}
+	}
+
+	return daedalus::core::tools::Result<void>();
+}
@@ -0,0 +1,100 @@
+#include <daedalus/core/session/session.hpp>
+
+daedalus::core::session::Session::Session(
+	daedalus::core::Daedalus& daedalus,
+	std::shared_ptr<daedalus::core::env::Environment> env
+) :
+	daedalus(daedalus),
+	env(env),
+	program(std::make_shared<daedalus::core::ast::Scope>()),
+	fragmentCount(0)
+{
+	if(this->env == nullptr) {
+		this->env = this->make_env();
+	}
+}
+
+std::vector<daedalus::core::interpreter::RuntimeResult> daedalus::core::session::Session::feed(const std::string& src) {
+	this->fragmentCount++;
+
+	std::vector<daedalus::core::lexer::Token> tokens;
+	daedalus::core::lexer::lex(this->daedalus.lexer, tokens, src);
+
+	auto fragment = std::make_shared<daedalus::core::ast::Scope>();
+	daedalus::core::parser::parse(this->daedalus.parser, fragment, tokens);
+
+	std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body = fragment->get_body();
+	std::vector<daedalus::core::interpreter::RuntimeResult> results;
+	try {
+		daedalus::core::interpreter::interpret(this->daedalus.interpreter, results, fragment, this->env);
+	} catch(...) {
+		this->commit(body, results.size());
+		throw;
+	}
+	this->commit(body, body.size());
+
+	return results;
+}
+
+daedalus::core::tools::Result<std::vector<daedalus::core::interpreter::RuntimeResult>> daedalus::core::session::Session::try_feed(const std::string& src) {
+	this->fragmentCount++;
+
+	std::vector<daedalus::core::lexer::Token> tokens;
+	daedalus::core::tools::Result<void> lexed = daedalus::core::lexer::try_lex(this->daedalus.lexer, tokens, src);
+	if(!lexed) {
+		return lexed.error();
+	}
+
+	auto fragment = std::make_shared<daedalus::core::ast::Scope>();
+	daedalus::core::tools::Result<void> parsed = daedalus::core::parser::try_parse(this->daedalus.parser, fragment, tokens);
+	if(!parsed) {
+		return parsed.error();
+	}
+
+	std::vector<std::shared_ptr<daedalus::core::ast::Expression>> body = fragment->get_body();
+	std::vector<daedalus::core::interpreter::RuntimeResult> results;
+	daedalus::core::tools::Result<void> interpreted = daedalus::core::interpreter::try_interpret(this->daedalus.interpreter, results, fragment, this->env);
+	if(!interpreted) {
+		this->commit(body, interpreted.error().offset);
+		return interpreted.error();
+	}
+	this->commit(body, body.size());
+
+	return results;
+}
+
+std::shared_ptr<daedalus::core::env::Environment> daedalus::core::session::Session::get_env() {
+	return this->env;
+}
+
+std::shared_ptr<daedalus::core::ast::Scope> daedalus::core::session::Session::get_program() {
+	return this->program;
+}
+
+size_t daedalus::core::session::Session::get_fragment_count() {
+	return this->fragmentCount;
+}
+
+void daedalus::core::session::Session::reset(std::shared_ptr<daedalus::core::env::Environment> env) {
+	this->env = env != nullptr ? env : this->make_env();
+	this->program = std::make_shared<daedalus::core::ast::Scope>();
+	this->fragmentCount = 0;
+}
+
+void daedalus::core::session::Session::commit(
+	const std::vector<std::shared_ptr<daedalus::core::ast::Expression>>& body,
+	size_t evaluated
+) {
+	for(size_t i = 0; i < evaluated && i < body.size(); i++) {
+		this->program->push_back_body(body[i]);
+	}
+}
+
+std::shared_ptr<daedalus::core::env::Environment> daedalus::core::session::Session::make_env() {
+	auto env = daedalus::core::env::make_environment(
+		this->daedalus.interpreter.envValuesProperties,
+		this->daedalus.interpreter.validationRules
+	);
+	env->set_profiler(this->daedalus.interpreter.profiler);
+	return env;
+}
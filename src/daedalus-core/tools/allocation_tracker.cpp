@@ -0,0 +1,262 @@
+#include <daedalus/core/tools/allocation_tracker.hpp>
+#include <daedalus/core/tools/assert.hpp>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * Size of the header `tracked_allocate` stores the block size in, keeping blocks aligned as `std::max_align_t`
+ */
+#define DAE_TRACKED_HEADER_SIZE alignof(std::max_align_t)
+
+namespace {
+	thread_local daedalus::core::tools::PipelinePhase currentPhase = daedalus::core::tools::PipelinePhase::NONE;
+
+	/**
+	 * Depth of the `UntrackedScope`s of the calling thread
+	 */
+	thread_local size_t untrackedDepth = 0;
+
+	std::atomic<const daedalus::core::tools::AllocationHooks*> installedHooks = nullptr;
+
+	/**
+	 * Number of calls to the installed hooks in progress, uninstalling them waits for it to drop to 0
+	 */
+	std::atomic<size_t> notifyingHooks = 0;
+
+	/**
+	 * Call a hook of the installed hooks, unless they were uninstalled in the meantime
+	 */
+	void notify(size_t size, bool allocated) {
+		if(installedHooks.load(std::memory_order_relaxed) == nullptr || untrackedDepth != 0) {
+			return;
+		}
+
+		notifyingHooks.fetch_add(1);
+		const daedalus::core::tools::AllocationHooks* hooks = installedHooks.load();
+		if(hooks != nullptr) {
+			if(allocated) {
+				hooks->on_allocate(hooks->userData, size);
+			} else {
+				hooks->on_deallocate(hooks->userData, size);
+			}
+		}
+		notifyingHooks.fetch_sub(1);
+	}
+
+	void wait_for_notifications() {
+		while(notifyingHooks.load() != 0) {
+			std::this_thread::yield();
+		}
+	}
+
+	long long signed_size(size_t size) {
+		return static_cast<long long>(size);
+	}
+}
+
+daedalus::core::tools::PipelinePhase daedalus::core::tools::get_pipeline_phase() {
+	return currentPhase;
+}
+
+void daedalus::core::tools::set_pipeline_phase(daedalus::core::tools::PipelinePhase phase) {
+	currentPhase = phase;
+}
+
+daedalus::core::tools::PipelinePhaseScope::PipelinePhaseScope(daedalus::core::tools::PipelinePhase phase) :
+	previous(currentPhase)
+{
+	currentPhase = phase;
+}
+
+daedalus::core::tools::PipelinePhaseScope::~PipelinePhaseScope() {
+	currentPhase = this->previous;
+}
+
+void daedalus::core::tools::set_allocation_hooks(const daedalus::core::tools::AllocationHooks* hooks) {
+	if(installedHooks.exchange(hooks) != nullptr) {
+		wait_for_notifications();
+	}
+}
+
+void daedalus::core::tools::notify_allocation(size_t size) {
+	notify(size, true);
+}
+
+void daedalus::core::tools::notify_deallocation(size_t size) {
+	notify(size, false);
+}
+
+daedalus::core::tools::UntrackedScope::UntrackedScope() {
+	untrackedDepth++;
+}
+
+daedalus::core::tools::UntrackedScope::~UntrackedScope() {
+	untrackedDepth--;
+}
+
+void* daedalus::core::tools::tracked_allocate(size_t size, const std::nothrow_t&) noexcept {
+	char* block = static_cast<char*>(std::malloc(size + DAE_TRACKED_HEADER_SIZE));
+	if(block == nullptr) {
+		return nullptr;
+	}
+
+	*reinterpret_cast<size_t*>(block) = size;
+	daedalus::core::tools::notify_allocation(size);
+	return block + DAE_TRACKED_HEADER_SIZE;
+}
+
+void* daedalus::core::tools::tracked_allocate(size_t size) {
+	void* block = daedalus::core::tools::tracked_allocate(size, std::nothrow);
+	if(block == nullptr) {
+		throw std::bad_alloc();
+	}
+	return block;
+}
+
+void daedalus::core::tools::tracked_deallocate(void* block) noexcept {
+	if(block == nullptr) {
+		return;
+	}
+
+	char* header = static_cast<char*>(block) - DAE_TRACKED_HEADER_SIZE;
+	daedalus::core::tools::notify_deallocation(*reinterpret_cast<size_t*>(header));
+	std::free(header);
+}
+
+daedalus::core::tools::AllocationTracker::AllocationTracker() :
+	hooks(daedalus::core::tools::AllocationHooks{
+		&daedalus::core::tools::AllocationTracker::on_allocate,
+		&daedalus::core::tools::AllocationTracker::on_deallocate,
+		this
+	}),
+	liveAllocations(0),
+	liveBytes(0)
+{
+	for(Counters& counters : this->phases) {
+		counters.allocations = 0;
+		counters.deallocations = 0;
+		counters.allocatedBytes = 0;
+		counters.freedBytes = 0;
+		counters.liveAllocations = 0;
+		counters.liveBytes = 0;
+	}
+}
+
+daedalus::core::tools::AllocationTracker::~AllocationTracker() {
+	this->stop();
+}
+
+void daedalus::core::tools::AllocationTracker::start() {
+	this->stop();
+
+	for(Counters& counters : this->phases) {
+		counters.allocations = 0;
+		counters.deallocations = 0;
+		counters.allocatedBytes = 0;
+		counters.freedBytes = 0;
+		counters.liveAllocations = 0;
+		counters.liveBytes = 0;
+	}
+	this->liveAllocations = 0;
+	this->liveBytes = 0;
+
+	// Another tracker's hooks are never replaced, it would silently stop counting
+	const daedalus::core::tools::AllocationHooks* expected = nullptr;
+	DAE_ASSERT_TRUE(
+		installedHooks.compare_exchange_strong(expected, &this->hooks),
+		std::runtime_error("Another allocation tracker is already running")
+	)
+}
+
+void daedalus::core::tools::AllocationTracker::stop() {
+	// Hooks still running on other threads must be done with the tracker before it can be destroyed
+	const daedalus::core::tools::AllocationHooks* expected = &this->hooks;
+	if(installedHooks.compare_exchange_strong(expected, nullptr)) {
+		wait_for_notifications();
+	}
+}
+
+void daedalus::core::tools::AllocationTracker::end_phase(daedalus::core::tools::PipelinePhase phase) {
+	Counters& counters = this->phases[static_cast<size_t>(phase)];
+	counters.liveAllocations = this->liveAllocations.load();
+	counters.liveBytes = this->liveBytes.load();
+}
+
+daedalus::core::tools::PhaseAllocations daedalus::core::tools::AllocationTracker::get_phase(daedalus::core::tools::PipelinePhase phase) const {
+	const Counters& counters = this->phases[static_cast<size_t>(phase)];
+	return daedalus::core::tools::PhaseAllocations{
+		counters.allocations.load(),
+		counters.deallocations.load(),
+		counters.allocatedBytes.load(),
+		counters.freedBytes.load(),
+		counters.liveAllocations.load(),
+		counters.liveBytes.load()
+	};
+}
+
+std::string daedalus::core::tools::AllocationTracker::repr() const {
+	std::string pretty = "";
+	for(size_t i = 0; i < DAE_PIPELINE_PHASE_COUNT; i++) {
+		daedalus::core::tools::PipelinePhase phase = static_cast<daedalus::core::tools::PipelinePhase>(i);
+		daedalus::core::tools::PhaseAllocations allocations = this->get_phase(phase);
+		pretty += daedalus::core::tools::repr(phase) +
+			": " + std::to_string(allocations.allocations) + " allocations (" + std::to_string(allocations.allocatedBytes) + " B)" +
+			", " + std::to_string(allocations.deallocations) + " deallocations (" + std::to_string(allocations.freedBytes) + " B)" +
+			", " + std::to_string(allocations.liveAllocations) + " live (" + std::to_string(allocations.liveBytes) + " B)\n";
+	}
+	return pretty;
+}
+
+void daedalus::core::tools::AllocationTracker::on_allocate(void* userData, size_t size) {
+	daedalus::core::tools::AllocationTracker* tracker = static_cast<daedalus::core::tools::AllocationTracker*>(userData);
+	Counters& counters = tracker->phases[static_cast<size_t>(currentPhase)];
+	counters.allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	tracker->liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	tracker->liveBytes.fetch_add(signed_size(size), std::memory_order_relaxed);
+}
+
+void daedalus::core::tools::AllocationTracker::on_deallocate(void* userData, size_t size) {
+	daedalus::core::tools::AllocationTracker* tracker = static_cast<daedalus::core::tools::AllocationTracker*>(userData);
+	Counters& counters = tracker->phases[static_cast<size_t>(currentPhase)];
+	counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+	counters.freedBytes.fetch_add(size, std::memory_order_relaxed);
+	tracker->liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	tracker->liveBytes.fetch_sub(signed_size(size), std::memory_order_relaxed);
+}
+
+std::vector<std::string> daedalus::core::tools::check_allocation_budgets(
+	const daedalus::core::tools::AllocationTracker& tracker,
+	const std::vector<daedalus::core::tools::AllocationBudget>& budgets
+) {
+	std::vector<std::string> violations;
+
+	for(const daedalus::core::tools::AllocationBudget& budget : budgets) {
+		daedalus::core::tools::PhaseAllocations allocations = tracker.get_phase(budget.phase);
+		std::string phase = daedalus::core::tools::repr(budget.phase);
+
+		if(allocations.allocations > budget.maxAllocations) {
+			violations.push_back(phase + " did " + std::to_string(allocations.allocations) + " allocations, budget is " + std::to_string(budget.maxAllocations));
+		}
+		if(allocations.allocatedBytes > budget.maxBytes) {
+			violations.push_back(phase + " allocated " + std::to_string(allocations.allocatedBytes) + " B, budget is " + std::to_string(budget.maxBytes));
+		}
+		if(allocations.liveBytes > budget.maxLiveBytes) {
+			violations.push_back(phase + " left " + std::to_string(allocations.liveBytes) + " B live, budget is " + std::to_string(budget.maxLiveBytes));
+		}
+	}
+
+	return violations;
+}
+
+std::string daedalus::core::tools::repr(daedalus::core::tools::PipelinePhase phase) {
+	switch(phase) {
+		case daedalus::core::tools::PipelinePhase::LEXER: return "lexer";
+		case daedalus::core::tools::PipelinePhase::PARSER: return "parser";
+		case daedalus::core::tools::PipelinePhase::OPTIMIZER: return "optimizer";
+		case daedalus::core::tools::PipelinePhase::INTERPRETER: return "interpreter";
+		default: return "none";
+	}
+}
@@ -0,0 +1,88 @@
+#include <daedalus/core/tools/profiler.hpp>
+
+#include <chrono>
+
+namespace {
+	uint64_t now_ns() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count());
+	}
+}
+
+void daedalus::core::tools::Profiler::enter(const std::string& name) {
+	std::string stack = this->frames.empty() ? name : this->frames.back().stack + ";" + name;
+	this->openFrames[name]++;
+	this->frames.push_back(Frame{
+		name,
+		std::move(stack),
+		now_ns(),
+		0
+	});
+}
+
+void daedalus::core::tools::Profiler::exit() {
+	if(this->frames.empty()) {
+		return;
+	}
+
+	uint64_t end = now_ns();
+	Frame frame = std::move(this->frames.back());
+	this->frames.pop_back();
+
+	uint64_t inclusive = end - frame.start;
+	uint64_t exclusive = inclusive > frame.childrenNs ? inclusive - frame.childrenNs : 0;
+
+	daedalus::core::tools::ProfileEntry& entry = this->entries[frame.name];
+	entry.calls++;
+	entry.exclusiveNs += exclusive;
+	if(--this->openFrames[frame.name] == 0) {
+		entry.inclusiveNs += inclusive;
+	}
+
+	this->stacks[frame.stack] += exclusive;
+
+	if(!this->frames.empty()) {
+		this->frames.back().childrenNs += inclusive;
+	}
+}
+
+const std::unordered_map<std::string, daedalus::core::tools::ProfileEntry>& daedalus::core::tools::Profiler::get_entries() {
+	return this->entries;
+}
+
+daedalus::core::tools::ProfileEntry daedalus::core::tools::Profiler::get_entry(const std::string& name) {
+	auto entry = this->entries.find(name);
+	if(entry == this->entries.end()) {
+		return daedalus::core::tools::ProfileEntry{ 0, 0, 0 };
+	}
+	return entry->second;
+}
+
+std::string daedalus::core::tools::Profiler::collapsed_stacks() {
+	std::string collapsed = "";
+	for(const auto& [stack, ns] : this->stacks) {
+		collapsed += stack + " " + std::to_string(ns) + "\n";
+	}
+	return collapsed;
+}
+
+void daedalus::core::tools::Profiler::reset() {
+	this->frames.clear();
+	this->entries.clear();
+	this->stacks.clear();
+	this->openFrames.clear();
+}
+
+daedalus::core::tools::ProfileScope::ProfileScope(
+	daedalus::core::tools::Profiler& profiler,
+	const std::string& name
+) :
+	profiler(profiler)
+{
+	this->profiler.enter(name);
+}
+
+daedalus::core::tools::ProfileScope::~ProfileScope() {
+	this->profiler.exit();
+}
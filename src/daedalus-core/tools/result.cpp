@@ -0,0 +1,51 @@
+#include <daedalus/core/tools/result.hpp>
+
+#include <algorithm>
+
+/**
+ * Maximum number of characters of the source quoted in an error message
+ */
+#define DAE_ERROR_EXCERPT_LENGTH 32
+
+namespace {
+	std::string describe(daedalus::core::tools::ErrorCode code) {
+		switch(code) {
+			case daedalus::core::tools::ErrorCode::UNKNOWN_TOKEN: return "Unknown token";
+			case daedalus::core::tools::ErrorCode::UNCLOSED_COMMENT: return "Comment being opened and not closed before EOF";
+			case daedalus::core::tools::ErrorCode::UNOPENED_COMMENT: return "Comment being closed without being opened";
+			case daedalus::core::tools::ErrorCode::UNKNOWN_NODE: return "Unknown token found";
+			case daedalus::core::tools::ErrorCode::PARSE_ERROR: return "Parsing error";
+			case daedalus::core::tools::ErrorCode::INVALID_NUMBER: return "Invalid number";
+			case daedalus::core::tools::ErrorCode::UNKNOWN_STATEMENT: return "Trying to evaluate unknown statement";
+			case daedalus::core::tools::ErrorCode::READ_ERROR: return "Cannot read source file";
+			default: return "Evaluation error";
+		}
+	}
+}
+
+std::string daedalus::core::tools::format_error(const daedalus::core::tools::Error& error, const std::string& src) {
+	std::string message = error.detail.empty() ? describe(error.code) : error.detail;
+
+	bool isEvaluation = error.code == daedalus::core::tools::ErrorCode::UNKNOWN_STATEMENT || error.code == daedalus::core::tools::ErrorCode::EVALUATION_ERROR;
+	if(isEvaluation) {
+		return message + " (statement " + std::to_string(error.offset) + ")";
+	}
+	if(error.code == daedalus::core::tools::ErrorCode::READ_ERROR) {
+		return message;
+	}
+	if(src.empty() || error.offset > src.length()) {
+		return message + " (offset " + std::to_string(error.offset) + ")";
+	}
+
+	size_t line = 1 + std::count(src.begin(), src.begin() + error.offset, '\n');
+	size_t lineStart = src.rfind('\n', error.offset == 0 ? 0 : error.offset - 1);
+	size_t column = 1 + error.offset - (lineStart == std::string::npos || lineStart >= error.offset ? 0 : lineStart + 1);
+
+	size_t excerptEnd = std::min({ src.find('\n', error.offset), src.length(), error.offset + DAE_ERROR_EXCERPT_LENGTH });
+	std::string excerpt = src.substr(error.offset, excerptEnd - error.offset);
+	if(excerptEnd < src.length() && src[excerptEnd] != '\n') {
+		excerpt += "...";
+	}
+
+	return message + " at line " + std::to_string(line) + ", column " + std::to_string(column) + " in \"" + excerpt + "\"";
+}
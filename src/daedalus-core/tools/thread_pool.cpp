@@ -0,0 +1,188 @@
+#include <daedalus/core/tools/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace {
+	/**
+	 * The pool the current thread works for, and its index in it
+	 */
+	thread_local const daedalus::core::tools::ThreadPool* currentPool = nullptr;
+	thread_local size_t currentWorker = 0;
+}
+
+daedalus::core::tools::ThreadPool::ThreadPool(size_t threadCount) :
+	queued(0),
+	pending(0),
+	conditionWaiters(0),
+	nextQueue(0),
+	stopping(false),
+	executed(0),
+	stolen(0),
+	error(nullptr)
+{
+	if(threadCount == 0) {
+		threadCount = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	}
+
+	for(size_t i = 0; i < threadCount; i++) {
+		this->queues.push_back(std::make_unique<WorkerQueue>());
+	}
+	for(size_t i = 0; i < threadCount; i++) {
+		this->threads.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+daedalus::core::tools::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for(std::thread& thread : this->threads) {
+		thread.join();
+	}
+}
+
+void daedalus::core::tools::ThreadPool::submit(daedalus::core::tools::ThreadPool::Task task) {
+	size_t worker = currentPool == this ? currentWorker : this->nextQueue++ % this->queues.size();
+
+	// Counted before being pushed, so the counters never go below the tasks actually queued
+	this->pending++;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->queued++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->queues[worker]->mutex);
+		this->queues[worker]->tasks.push_back(std::move(task));
+	}
+	this->wake.notify_one();
+	this->idle.notify_all();
+}
+
+void daedalus::core::tools::ThreadPool::wait() {
+	size_t worker = currentPool == this ? currentWorker : this->queues.size();
+
+	while(true) {
+		if(this->run_one(worker)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->idle.wait(lock, [this] () {
+			return this->pending == 0 || this->queued != 0;
+		});
+		if(this->pending == 0) {
+			break;
+		}
+	}
+
+	std::exception_ptr error = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::swap(error, this->error);
+	}
+	if(error != nullptr) {
+		std::rethrow_exception(error);
+	}
+}
+
+void daedalus::core::tools::ThreadPool::wait_until(const std::function<bool ()>& done) {
+	size_t worker = currentPool == this ? currentWorker : this->queues.size();
+
+	while(!done()) {
+		if(this->run_one(worker)) {
+			continue;
+		}
+
+		// Counted under the lock, so a task finishing after the condition was checked sees the waiter and notifies it
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->conditionWaiters++;
+		this->idle.wait(lock, [this, &done] () {
+			return this->queued != 0 || done();
+		});
+		this->conditionWaiters--;
+	}
+}
+
+size_t daedalus::core::tools::ThreadPool::get_thread_count() {
+	return this->threads.size();
+}
+
+daedalus::core::tools::ThreadPoolStats daedalus::core::tools::ThreadPool::get_stats() {
+	return daedalus::core::tools::ThreadPoolStats{
+		this->executed.load(),
+		this->stolen.load()
+	};
+}
+
+bool daedalus::core::tools::ThreadPool::run_one(size_t worker) {
+	Task task = nullptr;
+	bool steal = false;
+
+	// Own tasks newest first, for locality
+	if(worker < this->queues.size()) {
+		std::lock_guard<std::mutex> lock(this->queues[worker]->mutex);
+		if(!this->queues[worker]->tasks.empty()) {
+			task = std::move(this->queues[worker]->tasks.back());
+			this->queues[worker]->tasks.pop_back();
+		}
+	}
+
+	// Other tasks oldest first, the owner working on the other end
+	for(size_t i = 1; task == nullptr && i <= this->queues.size(); i++) {
+		WorkerQueue& victim = *this->queues[(worker + i) % this->queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if(!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			steal = true;
+		}
+	}
+
+	if(task == nullptr) {
+		return false;
+	}
+
+	this->queued--;
+	if(steal) {
+		this->stolen++;
+	}
+
+	try {
+		task();
+	} catch(...) {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if(this->error == nullptr) {
+			this->error = std::current_exception();
+		}
+	}
+
+	this->executed++;
+	if(--this->pending == 0 || this->conditionWaiters != 0) {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+		}
+		this->idle.notify_all();
+	}
+	return true;
+}
+
+void daedalus::core::tools::ThreadPool::work(size_t worker) {
+	currentPool = this;
+	currentWorker = worker;
+
+	while(true) {
+		if(this->run_one(worker)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->wake.wait(lock, [this] () {
+			return this->stopping || this->queued != 0;
+		});
+		if(this->stopping && this->queued == 0) {
+			return;
+		}
+	}
+}
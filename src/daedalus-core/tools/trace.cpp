@@ -0,0 +1,421 @@
+#include <daedalus/core/tools/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+/**
+ * Version of the binary format written by `write_trace`
+ */
+#define DAE_TRACE_FORMAT_VERSION 1
+
+std::atomic<bool> daedalus::core::tools::tracingEnabled = false;
+
+namespace {
+	const char TRACE_MAGIC[8] = { 'D', 'A', 'E', 'T', 'R', 'A', 'C', 'E' };
+
+	/**
+	 * An event slot, written by its ring's thread while other threads can read it
+	 * @note The fields are atomic and stamped, a reader keeping an event only if the stamp did not change while reading it
+	 */
+	typedef struct TraceSlot {
+		/**
+		 * Index of the event held plus one (`0` while it is written)
+		 */
+		std::atomic<uint64_t> stamp;
+		std::atomic<uint64_t> timestamp;
+		/**
+		 * The name, thread and type of the event
+		 */
+		std::atomic<uint64_t> packed;
+	} TraceSlot;
+
+	/**
+	 * The events of a single thread, written by it only
+	 */
+	typedef struct TraceRing {
+		std::unique_ptr<TraceSlot[]> slots;
+		size_t capacity;
+		size_t mask;
+		/**
+		 * Number of events ever recorded, the next one going to `head & mask`
+		 */
+		std::atomic<uint64_t> head;
+		uint16_t thread;
+	} TraceRing;
+
+	typedef struct TraceRegistry {
+		std::mutex mutex;
+		std::vector<std::shared_ptr<TraceRing>> rings;
+		std::vector<std::string> names = { "error", "other" };
+		std::unordered_map<std::string, uint32_t> ids = { { "error", DAE_TRACE_ERROR_NAME }, { "other", DAE_TRACE_OTHER_NAME } };
+		/**
+		 * Whether `names` reached `DAE_TRACE_MAX_NAMES`, read without the lock
+		 */
+		std::atomic<bool> full = false;
+		size_t capacity = DAE_TRACE_DEFAULT_CAPACITY;
+		std::string errorPath;
+		uint16_t nextThread = 0;
+	} TraceRegistry;
+
+	TraceRegistry& registry() {
+		static TraceRegistry registry;
+		return registry;
+	}
+
+	thread_local std::shared_ptr<TraceRing> threadRing = nullptr;
+	/**
+	 * The names already looked up by the calling thread, names being never dropped
+	 * @note Only the kept names are cached, so the cache is bounded as the names are
+	 */
+	thread_local std::unordered_map<std::string, uint32_t> threadNames;
+
+	uint64_t now_ns() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count());
+	}
+
+	size_t round_up(size_t capacity) {
+		size_t rounded = 1;
+		while(rounded < capacity) {
+			rounded <<= 1;
+		}
+		return rounded;
+	}
+
+	TraceRing& thread_ring() {
+		if(threadRing == nullptr) {
+			TraceRegistry& traces = registry();
+			std::lock_guard<std::mutex> lock(traces.mutex);
+
+			threadRing = std::make_shared<TraceRing>();
+			size_t capacity = round_up(std::max<size_t>(traces.capacity, 1));
+			threadRing->slots = std::make_unique<TraceSlot[]>(capacity);
+			threadRing->capacity = capacity;
+			threadRing->mask = capacity - 1;
+			threadRing->head = 0;
+			threadRing->thread = traces.nextThread++;
+			traces.rings.push_back(threadRing);
+		}
+		return *threadRing;
+	}
+
+	const char* describe(daedalus::core::tools::TraceEventType type) {
+		switch(type) {
+			case daedalus::core::tools::TraceEventType::NODE_ENTER: return "enter";
+			case daedalus::core::tools::TraceEventType::NODE_EXIT: return "exit";
+			case daedalus::core::tools::TraceEventType::ENV_GET: return "get";
+			case daedalus::core::tools::TraceEventType::ENV_SET: return "set";
+			case daedalus::core::tools::TraceEventType::ENV_INIT: return "init";
+			case daedalus::core::tools::TraceEventType::VALIDATION_RULE: return "rule";
+			default: return "error";
+		}
+	}
+
+	std::string json_string(const std::string& str) {
+		std::string escaped = "\"";
+		for(char c : str) {
+			if(c == '"' || c == '\\') {
+				escaped += '\\';
+				escaped += c;
+			} else if(static_cast<unsigned char>(c) < 0x20) {
+				char code[8];
+				std::snprintf(code, sizeof(code), "\\u%04x", c);
+				escaped += code;
+			} else {
+				escaped += c;
+			}
+		}
+		return escaped + "\"";
+	}
+
+	const std::string& event_name(const daedalus::core::tools::TraceDump& dump, const daedalus::core::tools::TraceEvent& event) {
+		static const std::string unknown = "?";
+		return event.name < dump.names.size() ? dump.names[event.name] : unknown;
+	}
+
+	template<typename T>
+	void write_raw(std::ostream& out, T value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template<typename T>
+	T read_raw(std::istream& in) {
+		T value;
+		in.read(reinterpret_cast<char*>(&value), sizeof(value));
+		if(!in) {
+			throw std::runtime_error("Truncated trace");
+		}
+		return value;
+	}
+}
+
+void daedalus::core::tools::enable_tracing(size_t capacity) {
+	{
+		TraceRegistry& traces = registry();
+		std::lock_guard<std::mutex> lock(traces.mutex);
+		traces.capacity = capacity;
+	}
+	daedalus::core::tools::tracingEnabled = true;
+}
+
+void daedalus::core::tools::disable_tracing() {
+	daedalus::core::tools::tracingEnabled = false;
+}
+
+uint32_t daedalus::core::tools::trace_name(const std::string& name) {
+	auto cached = threadNames.find(name);
+	if(cached != threadNames.end()) {
+		return cached->second;
+	}
+
+	TraceRegistry& traces = registry();
+	if(traces.full.load(std::memory_order_relaxed)) {
+		return DAE_TRACE_OTHER_NAME;
+	}
+
+	std::lock_guard<std::mutex> lock(traces.mutex);
+	auto id = traces.ids.find(name);
+	if(id == traces.ids.end()) {
+		if(traces.names.size() >= DAE_TRACE_MAX_NAMES) {
+			traces.full.store(true, std::memory_order_relaxed);
+			return DAE_TRACE_OTHER_NAME;
+		}
+		id = traces.ids.emplace(name, static_cast<uint32_t>(traces.names.size())).first;
+		traces.names.push_back(name);
+	}
+	threadNames.emplace(name, id->second);
+	return id->second;
+}
+
+void daedalus::core::tools::trace(daedalus::core::tools::TraceEventType type, uint32_t name) {
+	TraceRing& ring = thread_ring();
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+	TraceSlot& slot = ring.slots[head & ring.mask];
+
+	slot.stamp.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.timestamp.store(now_ns(), std::memory_order_relaxed);
+	slot.packed.store(
+		static_cast<uint64_t>(name) | static_cast<uint64_t>(ring.thread) << 32 | static_cast<uint64_t>(type) << 48,
+		std::memory_order_relaxed
+	);
+	slot.stamp.store(head + 1, std::memory_order_release);
+
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void daedalus::core::tools::trace(daedalus::core::tools::TraceEventType type, const std::string& name) {
+	daedalus::core::tools::trace(type, daedalus::core::tools::trace_name(name));
+}
+
+daedalus::core::tools::TraceDump daedalus::core::tools::dump_trace() {
+	daedalus::core::tools::TraceDump dump;
+	TraceRegistry& traces = registry();
+	std::lock_guard<std::mutex> lock(traces.mutex);
+
+	for(const std::shared_ptr<TraceRing>& ring : traces.rings) {
+		uint64_t head = ring->head.load(std::memory_order_acquire);
+		uint64_t start = head > ring->capacity ? head - ring->capacity : 0;
+
+		for(uint64_t i = start; i < head; i++) {
+			const TraceSlot& slot = ring->slots[i & ring->mask];
+			uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+			uint64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+			uint64_t packed = slot.packed.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// The owner overwrote or is overwriting the slot with a newer event, which is skipped
+			if(stamp != i + 1 || slot.stamp.load(std::memory_order_relaxed) != stamp) {
+				continue;
+			}
+			dump.events.push_back(daedalus::core::tools::TraceEvent{
+				timestamp,
+				static_cast<uint32_t>(packed),
+				static_cast<uint16_t>(packed >> 32),
+				static_cast<daedalus::core::tools::TraceEventType>(packed >> 48)
+			});
+		}
+	}
+
+	std::stable_sort(dump.events.begin(), dump.events.end(), [] (const daedalus::core::tools::TraceEvent& first, const daedalus::core::tools::TraceEvent& second) {
+		return first.timestamp < second.timestamp;
+	});
+	dump.names = traces.names;
+	return dump;
+}
+
+void daedalus::core::tools::clear_trace() {
+	TraceRegistry& traces = registry();
+	std::lock_guard<std::mutex> lock(traces.mutex);
+
+	// The rings of exited threads are only held by the registry
+	traces.rings.erase(
+		std::remove_if(traces.rings.begin(), traces.rings.end(), [] (const std::shared_ptr<TraceRing>& ring) {
+			return ring.use_count() == 1;
+		}),
+		traces.rings.end()
+	);
+	for(const std::shared_ptr<TraceRing>& ring : traces.rings) {
+		ring->head = 0;
+	}
+}
+
+void daedalus::core::tools::set_trace_error_path(const std::string& path) {
+	TraceRegistry& traces = registry();
+	std::lock_guard<std::mutex> lock(traces.mutex);
+	traces.errorPath = path;
+}
+
+void daedalus::core::tools::trace_error() {
+	daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::ERROR, DAE_TRACE_ERROR_NAME);
+
+	std::string path;
+	{
+		TraceRegistry& traces = registry();
+		std::lock_guard<std::mutex> lock(traces.mutex);
+		path = traces.errorPath;
+	}
+	if(path.empty()) {
+		return;
+	}
+
+	std::ofstream out(path, std::ios::binary);
+	daedalus::core::tools::write_trace(daedalus::core::tools::dump_trace(), out);
+}
+
+void daedalus::core::tools::write_trace(const daedalus::core::tools::TraceDump& dump, std::ostream& out) {
+	out.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	write_raw<uint32_t>(out, DAE_TRACE_FORMAT_VERSION);
+
+	write_raw<uint32_t>(out, static_cast<uint32_t>(dump.names.size()));
+	for(const std::string& name : dump.names) {
+		write_raw<uint32_t>(out, static_cast<uint32_t>(name.length()));
+		out.write(name.data(), name.length());
+	}
+
+	// Field by field, so the padding of `TraceEvent` is not written
+	write_raw<uint64_t>(out, dump.events.size());
+	for(const daedalus::core::tools::TraceEvent& event : dump.events) {
+		write_raw<uint64_t>(out, event.timestamp);
+		write_raw<uint32_t>(out, event.name);
+		write_raw<uint16_t>(out, event.thread);
+		write_raw<uint8_t>(out, static_cast<uint8_t>(event.type));
+	}
+}
+
+daedalus::core::tools::TraceDump daedalus::core::tools::read_trace(std::istream& in) {
+	char magic[sizeof(TRACE_MAGIC)];
+	in.read(magic, sizeof(magic));
+	if(!in || !std::equal(magic, magic + sizeof(magic), TRACE_MAGIC)) {
+		throw std::runtime_error("Not a trace");
+	}
+	uint32_t version = read_raw<uint32_t>(in);
+	if(version != DAE_TRACE_FORMAT_VERSION) {
+		throw std::runtime_error("Unsupported trace version " + std::to_string(version));
+	}
+
+	daedalus::core::tools::TraceDump dump;
+
+	uint32_t nameCount = read_raw<uint32_t>(in);
+	for(uint32_t i = 0; i < nameCount; i++) {
+		std::string name(read_raw<uint32_t>(in), '\0');
+		in.read(name.data(), name.length());
+		if(!in) {
+			throw std::runtime_error("Truncated trace");
+		}
+		dump.names.push_back(std::move(name));
+	}
+
+	uint64_t eventCount = read_raw<uint64_t>(in);
+	for(uint64_t i = 0; i < eventCount; i++) {
+		daedalus::core::tools::TraceEvent event;
+		event.timestamp = read_raw<uint64_t>(in);
+		event.name = read_raw<uint32_t>(in);
+		event.thread = read_raw<uint16_t>(in);
+		event.type = static_cast<daedalus::core::tools::TraceEventType>(read_raw<uint8_t>(in));
+		dump.events.push_back(event);
+	}
+
+	return dump;
+}
+
+std::string daedalus::core::tools::trace_to_text(const daedalus::core::tools::TraceDump& dump) {
+	std::string text = "";
+	uint64_t origin = dump.events.empty() ? 0 : dump.events.front().timestamp;
+
+	for(const daedalus::core::tools::TraceEvent& event : dump.events) {
+		char prefix[64];
+		std::snprintf(
+			prefix,
+			sizeof(prefix),
+			"%12.3f us  thread %-3u %-6s ",
+			(event.timestamp - origin) / 1000.0,
+			static_cast<unsigned int>(event.thread),
+			describe(event.type)
+		);
+		text += prefix + event_name(dump, event) + "\n";
+	}
+	return text;
+}
+
+std::string daedalus::core::tools::trace_to_chrome_json(const daedalus::core::tools::TraceDump& dump) {
+	std::string json = "{\"traceEvents\":[";
+	uint64_t origin = dump.events.empty() ? 0 : dump.events.front().timestamp;
+
+	for(size_t i = 0; i < dump.events.size(); i++) {
+		const daedalus::core::tools::TraceEvent& event = dump.events[i];
+
+		// Nodes are duration events, the others instant events
+		const char* phase = "i";
+		std::string category = "env";
+		if(event.type == daedalus::core::tools::TraceEventType::NODE_ENTER) {
+			phase = "B";
+			category = "node";
+		} else if(event.type == daedalus::core::tools::TraceEventType::NODE_EXIT) {
+			phase = "E";
+			category = "node";
+		} else if(event.type == daedalus::core::tools::TraceEventType::ERROR) {
+			category = "error";
+		}
+
+		char timing[96];
+		std::snprintf(
+			timing,
+			sizeof(timing),
+			"\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+			(event.timestamp - origin) / 1000.0,
+			static_cast<unsigned int>(event.thread)
+		);
+
+		json += i == 0 ? "\n" : ",\n";
+		json += "{\"name\":" + json_string(event_name(dump, event)) +
+			",\"cat\":\"" + category + "\",\"ph\":\"" + phase + "\"," + timing;
+		if(phase[0] == 'i') {
+			json += ",\"s\":\"t\",\"args\":{\"op\":\"" + std::string(describe(event.type)) + "\"}";
+		}
+		json += "}";
+	}
+
+	return json + "\n]}\n";
+}
+
+daedalus::core::tools::TraceNodeScope::TraceNodeScope(uint32_t name) :
+	name(name)
+{
+	daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::NODE_ENTER, this->name);
+}
+
+daedalus::core::tools::TraceNodeScope::TraceNodeScope(const std::string& name) :
+	TraceNodeScope(daedalus::core::tools::trace_name(name))
+{}
+
+daedalus::core::tools::TraceNodeScope::~TraceNodeScope() {
+	daedalus::core::tools::trace(daedalus::core::tools::TraceEventType::NODE_EXIT, this->name);
+}
@@ -11,6 +11,9 @@ project "Daedalus-Core"
 
 	includedirs { "include/" }
 
+	filter { "system:linux" }
+		links { "pthread" }
+
 	filter { "action:gmake" }
         buildoptions { "-Wall", "-Werror", "-Wpedantic" }
 
@@ -25,3 +28,49 @@ project "Daedalus-Core"
 
 	filter { "configurations:debug" }
 	    defines { "DEBUG" }
+
+project "Daedalus-Bench"
+	language "C++"
+	kind "ConsoleApp"
+	location "build/daedalus-bench"
+
+	files {
+		"daedalus-bench/**.cpp",
+		"daedalus-bench/**.hpp"
+	}
+
+	includedirs { "include/" }
+
+	links { "Daedalus-Core" }
+
+	optimize "Speed"
+
+	filter { "system:linux" }
+		links { "pthread" }
+
+	filter { "action:gmake" }
+        buildoptions { "-Wall", "-Werror", "-Wpedantic" }
+
+project "Daedalus-Complexity"
+	language "C++"
+	kind "ConsoleApp"
+	location "build/daedalus-complexity"
+
+	files {
+		"daedalus-complexity/**.cpp",
+		"daedalus-complexity/**.hpp",
+		"daedalus-bench/grammars.cpp",
+		"daedalus-bench/grammars.hpp"
+	}
+
+	includedirs { "include/" }
+
+	links { "Daedalus-Core" }
+
+	optimize "Speed"
+
+	filter { "system:linux" }
+		links { "pthread" }
+
+	filter { "action:gmake" }
+        buildoptions { "-Wall", "-Werror", "-Wpedantic" }
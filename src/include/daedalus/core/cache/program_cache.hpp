@@ -0,0 +1,144 @@
+#ifndef __DAEDALUS_CORE_PROGRAM_CACHE__
+#define __DAEDALUS_CORE_PROGRAM_CACHE__
+
+#include <daedalus/core/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace cache {
+
+    		/**
+    		 * Hash a language configuration: token type names, lexer settings, node keys and parser flags
+    		 * @param daedalus The configuration to hash
+    		 * @param salt A string to mix in, to be changed whenever the behaviour of a lexing or parsing function changes
+    		 * @return The fingerprint
+    		 * @note Functions cannot be hashed, two configurations only differing by their functions share a fingerprint unless salted
+    		 */
+    		uint64_t fingerprint(const daedalus::core::Daedalus& daedalus, const std::string& salt = "");
+
+    		/**
+    		 * Hash a source string
+    		 */
+    		uint64_t hash_source(const std::string& src);
+
+    		typedef struct ProgramCacheOptions {
+    			/**
+    			 * Maximum number of cached programs
+    			 */
+    			size_t maxEntries = 1024;
+    			/**
+    			 * Maximum size of the cached programs, sources and AST footprints included
+    			 */
+    			size_t maxBytes = 64 * 1024 * 1024;
+    		} ProgramCacheOptions;
+
+    		typedef struct ProgramCacheStats {
+    			size_t hits;
+    			size_t misses;
+    			size_t evictions;
+    			size_t entries;
+    			size_t bytes;
+    		} ProgramCacheStats;
+
+    		/**
+    		 * A thread-safe cache of parsed and optimized programs, evicting the least recently used ones
+    		 * @note Concurrent requests for a program being compiled wait for it instead of compiling it again
+    		 */
+    		class ProgramCache {
+    		public:
+    			ProgramCache(ProgramCacheOptions options = ProgramCacheOptions());
+
+    			/**
+    			 * Get the program of a source string, lexing and parsing it on a miss
+    			 * @param daedalus The configuration to compile with
+    			 * @param src The source string
+    			 * @param fingerprint The fingerprint of the configuration, as computed by `fingerprint`
+    			 * @return The program, shared with the other users of the cache
+    			 * @throw The lexing or parsing error, failed compilations not being cached
+    			 */
+    			std::shared_ptr<const daedalus::core::ast::Scope> get_or_compile(
+    				daedalus::core::Daedalus& daedalus,
+    				const std::string& src,
+    				uint64_t fingerprint
+    			);
+
+    			/**
+    			 * Get the program of a source string, computing the fingerprint of the configuration
+    			 */
+    			std::shared_ptr<const daedalus::core::ast::Scope> get_or_compile(
+    				daedalus::core::Daedalus& daedalus,
+    				const std::string& src
+    			);
+
+    			ProgramCacheStats get_stats();
+
+    			/**
+    			 * Drop every cached program (the statistics are kept)
+    			 */
+    			void clear();
+
+    		private:
+    			typedef std::shared_future<std::shared_ptr<const daedalus::core::ast::Scope>> ProgramFuture;
+
+    			typedef struct Entry {
+    				std::string source;
+    				uint64_t fingerprint;
+    				ProgramFuture program;
+    				/**
+    				 * `0` while compiling
+    				 */
+    				size_t bytes;
+    				/**
+    				 * Number of the compilation that created the entry, telling it from an entry created for the same source after it was dropped
+    				 */
+    				uint64_t compilation;
+    				std::list<uint64_t>::iterator recentUse;
+    			} Entry;
+
+    			/**
+    			 * Drop the least recently used compiled entries until the cache fits its limits
+    			 * @note Entries still compiling are kept, their compiling thread being the one to fill them
+    			 */
+    			void evict();
+
+    			ProgramCacheOptions options;
+    			std::mutex mutex;
+    			uint64_t compilations;
+    			std::unordered_map<uint64_t, Entry> entries;
+    			/**
+    			 * The keys of the entries, the most recently used first
+    			 */
+    			std::list<uint64_t> recentUses;
+    			ProgramCacheStats stats;
+    		};
+
+    		/**
+    		 * Interpret a source string through a program cache
+    		 * @param daedalus The configuration to use
+    		 * @param cache The cache to get the program from
+    		 * @param results The vector to fill with the results
+    		 * @param src The source string
+    		 * @param env The root environment to run in (a new one is created if `nullptr`)
+    		 */
+    		void run_cached(
+    			daedalus::core::Daedalus& daedalus,
+    			ProgramCache& cache,
+    			std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+    			const std::string& src,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    		);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_PROGRAM_CACHE__
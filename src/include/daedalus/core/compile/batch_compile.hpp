@@ -0,0 +1,115 @@
+#ifndef __DAEDALUS_CORE_BATCH_COMPILE__
+#define __DAEDALUS_CORE_BATCH_COMPILE__
+
+#include <daedalus/core/core.hpp>
+#include <daedalus/core/tools/result.hpp>
+#include <daedalus/core/tools/thread_pool.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace compile {
+
+    		/**
+    		 * A source to compile, either a file or an in-memory buffer
+    		 */
+    		typedef struct SourceInput {
+    			/**
+    			 * The path of the file, or the name of the buffer
+    			 */
+    			std::string name;
+    			std::string source;
+    			bool isPath;
+    		} SourceInput;
+
+    		SourceInput make_path_input(std::string path);
+    		SourceInput make_buffer_input(std::string name, std::string source);
+
+    		typedef struct CompiledSource {
+    			std::string name;
+    			/**
+    			 * The parsed program (`nullptr` on error)
+    			 */
+    			std::shared_ptr<daedalus::core::ast::Scope> program;
+    			std::optional<daedalus::core::tools::Error> error;
+    			/**
+    			 * The formatted error, with its line and column (empty on success)
+    			 */
+    			std::string message;
+    			size_t bytes;
+    			/**
+    			 * Number of tokens, `EOF` included (`0` when the lexing failed)
+    			 */
+    			size_t tokenCount;
+    			/**
+    			 * Time spent reading, lexing and parsing the source
+    			 */
+    			double seconds;
+    		} CompiledSource;
+
+    		typedef struct BatchCompileStats {
+    			size_t sources;
+    			size_t failures;
+    			size_t bytes;
+    			size_t tokens;
+    			/**
+    			 * Wall-clock time of the whole batch
+    			 */
+    			double seconds;
+    			/**
+    			 * Sum of the time spent on each source, over all threads
+    			 */
+    			double busySeconds;
+    			double sourcesPerSecond;
+    			double bytesPerSecond;
+    			size_t threadCount;
+    			/**
+    			 * Sources compiled by another worker than the one they were queued to
+    			 */
+    			size_t steals;
+    		} BatchCompileStats;
+
+    		typedef struct BatchCompilation {
+    			/**
+    			 * One entry per input, in input order
+    			 */
+    			std::vector<CompiledSource> sources;
+    			BatchCompileStats stats;
+    		} BatchCompilation;
+
+    		/**
+    		 * Lex and parse many sources in parallel
+    		 * @param daedalus The configuration to use, shared by every worker
+    		 * @param inputs The sources to compile
+    		 * @param pool The pool to run on
+    		 * @return The program or the error of each source, and the throughput of the batch
+    		 * @note The lexer and parser configurations are only read, but custom lexing and parsing functions must be safe to call from several threads
+    		 * @note Errors never stop the batch, failed sources only fill their own entry
+    		 */
+    		BatchCompilation compile_batch(
+    			daedalus::core::Daedalus& daedalus,
+    			const std::vector<SourceInput>& inputs,
+    			daedalus::core::tools::ThreadPool& pool
+    		);
+
+    		/**
+    		 * Lex and parse many sources in parallel, on a pool created for the batch
+    		 * @param threadCount Number of worker threads (`0` to use the hardware concurrency)
+    		 */
+    		BatchCompilation compile_batch(
+    			daedalus::core::Daedalus& daedalus,
+    			const std::vector<SourceInput>& inputs,
+    			size_t threadCount = 0
+    		);
+
+    		std::string repr(const BatchCompileStats& stats);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_BATCH_COMPILE__
@@ -4,15 +4,104 @@
 #include <daedalus/core/lexer/lexer.hpp>
 #include <daedalus/core/parser/parser.hpp>
 #include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/interpreter/compiler.hpp>
+#include <daedalus/core/interpreter/specialize.hpp>
+#include <daedalus/core/interpreter/batch.hpp>
+#include <daedalus/core/interpreter/kernels.hpp>
+#include <daedalus/core/interpreter/effects.hpp>
+#include <daedalus/core/interpreter/memo.hpp>
+#include <daedalus/core/tools/allocation_tracker.hpp>
+#include <daedalus/core/tools/trace.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace daedalus {
     namespace core {
+        /**
+         * The metrics of a single pipeline run
+         */
+        typedef struct PipelineMetrics {
+            double lexSeconds;
+            double parseSeconds;
+            /**
+             * Time spent in the `get_constexpr` pass (`0` when `OPTI_CONST_EXPR` is not set)
+             */
+            double optimizeSeconds;
+            double interpretSeconds;
+            /**
+             * Number of tokens, `EOF` included
+             */
+            size_t tokenCount;
+            /**
+             * Number of distinct AST nodes reachable through `get_children`, the program scope included
+             */
+            size_t nodeCount;
+            /**
+             * Peak size of the token buffer, token strings included
+             */
+            size_t tokenBytes;
+            /**
+             * Size of the optimized AST, as reported by `get_footprint`
+             */
+            size_t astBytes;
+            /**
+             * Environment operations done while interpreting
+             */
+            daedalus::core::env::EnvStats envStats;
+        } PipelineMetrics;
+
+        /**
+         * A function receiving the metrics of every run
+         */
+        typedef std::function<void (const PipelineMetrics& metrics)> MetricsSink;
+
+        /**
+         * The settings of a streaming run
+         */
+        typedef struct StreamingOptions {
+            /**
+             * Token types ending a top-level statement when found outside of brackets
+             */
+            std::vector<std::string> terminators = std::vector<std::string>({ ";" });
+            /**
+             * Opening and closing token types, a statement never ends between them
+             */
+            std::vector<std::pair<std::string, std::string>> brackets = std::vector<std::pair<std::string, std::string>>({
+                { "(", ")" },
+                { "{", "}" },
+                { "[", "]" },
+            });
+            size_t tokenQueueCapacity = 4096;
+            size_t statementQueueCapacity = 256;
+            /**
+             * The function to call with each result as soon as its statement is evaluated (`nullptr` to disable)
+             */
+            std::function<void (const daedalus::core::interpreter::RuntimeResult& result)> onResult = nullptr;
+            /**
+             * The flags ending the run when a top-level statement returns them, as the `escape_flag` of `evaluate_scope`
+             * @note The escaping statement gets no result, the rest of the source is neither parsed nor evaluated
+             */
+            daedalus::core::interpreter::Flags escapeFlag = 0;
+        } StreamingOptions;
+
         typedef struct Daedalus {
        		daedalus::core::lexer::Lexer lexer;
        		daedalus::core::parser::Parser parser;
        		daedalus::core::interpreter::Interpreter interpreter;
+       		/**
+       		 * The sink `run` reports its metrics to (`nullptr` to disable)
+       		 */
+       		MetricsSink metricsSink = nullptr;
+       		/**
+       		 * The tracker `run` attributes allocations to (`nullptr` to disable)
+       		 * @note Only the value pools report to it unless the executable uses `DAE_TRACK_GLOBAL_ALLOCATIONS`
+       		 */
+       		std::shared_ptr<daedalus::core::tools::AllocationTracker> allocationTracker = nullptr;
        	} Daedalus;
 
        	typedef std::function<void (daedalus::core::lexer::Lexer& lexer)> LexerConfigFunction;
@@ -24,6 +113,50 @@ namespace daedalus {
        		ParserConfigFunction parserConfigFunction,
        		InterpreterConfigFunction interpreterConfigFunction
        	);
+
+       	/**
+       	 * Lex, parse, optimize and interpret a source string
+       	 * @param daedalus The configuration to use
+       	 * @param results The vector to fill with the results
+       	 * @param src The source string
+       	 * @return The metrics of the run, also sent to `daedalus.metricsSink`
+       	 * @note When `daedalus.allocationTracker` is set, it is restarted and records the live allocations at the end of each phase
+       	 */
+       	PipelineMetrics run(
+       		Daedalus& daedalus,
+       		std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+       		std::string src
+       	);
+
+       	/**
+       	 * Lex, parse and interpret a source string as three concurrent stages
+       	 * @param daedalus The configuration to use
+       	 * @param results The vector to fill with the results
+       	 * @param src The source string
+       	 * @param options The statement boundaries and queue sizes
+       	 * @param env The root environment to run in (a new one is created if `nullptr`)
+       	 * @note The lexer and parser run on their own threads, each top-level statement being evaluated on the calling thread as soon as it is parsed
+       	 * @note The first error of any stage is rethrown once every stage stopped, the statements evaluated before it keep their results
+       	 */
+       	void run_streaming(
+       		Daedalus& daedalus,
+       		std::vector<daedalus::core::interpreter::RuntimeResult>& results,
+       		std::string src,
+       		StreamingOptions options = StreamingOptions(),
+       		std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+       	);
+
+       	/**
+       	 * Count the nodes of an AST and their footprint
+       	 * @param root The root of the AST
+       	 * @param nodeCount The variable to add the node count to
+       	 * @param astBytes The variable to add the footprint to
+       	 */
+       	void measure_ast(
+       		std::shared_ptr<daedalus::core::ast::Statement> root,
+       		size_t& nodeCount,
+       		size_t& astBytes
+       	);
     }
 }
 
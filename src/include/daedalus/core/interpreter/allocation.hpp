@@ -0,0 +1,277 @@
+#ifndef __DAEDALUS_CORE_ALLOCATION__
+#define __DAEDALUS_CORE_ALLOCATION__
+
+#include <daedalus/core/interpreter/values.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * The largest block size served by the per-thread pools, bigger blocks go straight to the heap
+ */
+#define DAE_POOL_MAX_BLOCK_SIZE 256
+
+/**
+ * The size of the chunks regions reserve from the heap, bigger blocks getting a chunk of their own
+ */
+#define DAE_REGION_CHUNK_SIZE (64 * 1024)
+
+namespace daedalus {
+    namespace core {
+        namespace values {
+
+    		/**
+    		 * Allocation counters of the calling thread
+    		 */
+    		typedef struct AllocationStats {
+    			/**
+    			 * Blocks requested from the heap
+    			 */
+    			size_t heapAllocations;
+    			/**
+    			 * Blocks reused from the pools
+    			 */
+    			size_t pooledAllocations;
+    			/**
+    			 * Blocks given back (to the pools or the heap)
+    			 */
+    			size_t deallocations;
+    			/**
+    			 * Bytes requested, pooled or not
+    			 */
+    			size_t bytes;
+    		} AllocationStats;
+
+    		/**
+    		 * Get the allocation counters of the calling thread
+    		 */
+    		AllocationStats get_allocation_stats();
+
+    		/**
+    		 * Reset the allocation counters of the calling thread
+    		 */
+    		void reset_allocation_stats();
+
+    		/**
+    		 * Allocate a block from the calling thread's pools
+    		 * @param size The size of the block
+    		 * @return The block, aligned as `std::max_align_t`
+    		 */
+    		void* pool_allocate(size_t size);
+
+    		/**
+    		 * Give a block back to the calling thread's pools
+    		 * @param block The block to give back
+    		 * @param size The size the block was allocated with
+    		 */
+    		void pool_deallocate(void* block, size_t size);
+
+    		/**
+    		 * A standard allocator drawing from the per-thread pools
+    		 */
+    		template<typename T>
+    		class PoolAllocator {
+    		public:
+    			typedef T value_type;
+
+    			static_assert(alignof(T) <= alignof(std::max_align_t), "Pooled types cannot be over-aligned");
+
+    			PoolAllocator() noexcept {}
+
+    			template<typename U>
+    			PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    			[[nodiscard]] T* allocate(size_t n) {
+    				return static_cast<T*>(pool_allocate(n * sizeof(T)));
+    			}
+
+    			void deallocate(T* pointer, size_t n) noexcept {
+    				pool_deallocate(pointer, n * sizeof(T));
+    			}
+
+    			template<typename U>
+    			bool operator==(const PoolAllocator<U>&) const noexcept {
+    				return true;
+    			}
+
+    			template<typename U>
+    			bool operator!=(const PoolAllocator<U>&) const noexcept {
+    				return false;
+    			}
+    		};
+
+    		/**
+    		 * The error thrown when a region runs out of quota
+    		 */
+    		class QuotaExceeded : public std::runtime_error {
+    		public:
+    			QuotaExceeded(size_t quota, size_t requested);
+    		};
+
+    		typedef struct RegionStats {
+    			size_t allocations;
+    			/**
+    			 * Bytes handed out, counted against the quota
+    			 */
+    			size_t bytes;
+    			/**
+    			 * Bytes reserved from the heap, unused chunk tails included
+    			 */
+    			size_t reservedBytes;
+    			/**
+    			 * `0` when unlimited
+    			 */
+    			size_t quota;
+    		} RegionStats;
+
+    		/**
+    		 * A bump allocator whose blocks are all given back to the heap at once, when the region is destroyed
+    		 * @note Allocating is not thread-safe, a region is meant to be installed on a single thread (see `RegionScope`)
+    		 */
+    		class Region {
+    		public:
+    			/**
+    			 * @param quota Maximum number of bytes handed out (`0` for no limit)
+    			 * @param chunkSize The size of the chunks reserved from the heap
+    			 */
+    			explicit Region(size_t quota = 0, size_t chunkSize = DAE_REGION_CHUNK_SIZE);
+    			~Region();
+
+    			Region(const Region&) = delete;
+    			Region& operator=(const Region&) = delete;
+
+    			/**
+    			 * Allocate a block
+    			 * @throw QuotaExceeded if the block does not fit in the quota
+    			 */
+    			void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    			/**
+    			 * Give a block back, its memory only being released with the region
+    			 */
+    			void deallocate(void* block, size_t size) noexcept;
+
+    			RegionStats get_stats();
+
+    		private:
+    			typedef struct Chunk {
+    				Chunk* next;
+    				size_t size;
+    			} Chunk;
+
+    			/**
+    			 * Reserve a chunk able to hold a block
+    			 */
+    			void reserve(size_t size, size_t alignment);
+
+    			Chunk* chunks;
+    			char* cursor;
+    			char* end;
+    			size_t chunkSize;
+    			RegionStats stats;
+    		};
+
+    		/**
+    		 * A standard allocator drawing from a region
+    		 * @note Every block keeps the region alive, values escaping a run pin its whole region until they are released
+    		 */
+    		template<typename T>
+    		class RegionAllocator {
+    		public:
+    			typedef T value_type;
+
+    			explicit RegionAllocator(std::shared_ptr<Region> region) noexcept :
+    				region(std::move(region))
+    			{}
+
+    			template<typename U>
+    			RegionAllocator(const RegionAllocator<U>& other) noexcept :
+    				region(other.region)
+    			{}
+
+    			[[nodiscard]] T* allocate(size_t n) {
+    				return static_cast<T*>(this->region->allocate(n * sizeof(T), alignof(T)));
+    			}
+
+    			void deallocate(T* pointer, size_t n) noexcept {
+    				this->region->deallocate(pointer, n * sizeof(T));
+    			}
+
+    			template<typename U>
+    			bool operator==(const RegionAllocator<U>& other) const noexcept {
+    				return this->region == other.region;
+    			}
+
+    			template<typename U>
+    			bool operator!=(const RegionAllocator<U>& other) const noexcept {
+    				return this->region != other.region;
+    			}
+
+    			std::shared_ptr<Region> region;
+    		};
+
+    		/**
+    		 * Get the region installed on the calling thread (`nullptr` if none)
+    		 */
+    		const std::shared_ptr<Region>& current_region();
+
+    		/**
+    		 * Install a region on the calling thread for as long as the object lives, `make_value` and `make_environment` drawing from it
+    		 * @note Scopes nest, a `nullptr` region suspending the installed one
+    		 */
+    		class RegionScope {
+    		public:
+    			explicit RegionScope(std::shared_ptr<Region> region);
+    			~RegionScope();
+
+    			RegionScope(const RegionScope&) = delete;
+    			RegionScope& operator=(const RegionScope&) = delete;
+
+    		private:
+    			std::shared_ptr<Region> previous;
+    		};
+
+    		/**
+    		 * Create a shared object from the region installed on the calling thread, or with a fallback allocator
+    		 * @param allocator The allocator to use when no region is installed
+    		 * @param args The arguments of the constructor
+    		 */
+    		template<typename T, typename Allocator, typename... Args>
+    		std::shared_ptr<T> allocate_in_region(const Allocator& allocator, Args&&... args) {
+    			const std::shared_ptr<Region>& region = current_region();
+    			if(region != nullptr) {
+    				return std::allocate_shared<T>(RegionAllocator<T>(region), std::forward<Args>(args)...);
+    			}
+    			return std::allocate_shared<T>(allocator, std::forward<Args>(args)...);
+    		}
+
+    		/**
+    		 * Create a runtime value from the installed region, or from the per-thread pools
+    		 * @param args The arguments of the value constructor
+    		 * @return The value, sharing a single block with its reference counter
+    		 */
+    		template<typename T, typename... Args>
+    		std::shared_ptr<T> make_value(Args&&... args) {
+    			return allocate_in_region<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    		}
+
+    		/**
+    		 * Copy a value out of the region it may live in, so it does not pin the region
+    		 * @param value The value to copy (can be `nullptr`)
+    		 * @return The copy, allocated from the per-thread pools
+    		 */
+    		std::shared_ptr<RuntimeValue> copy_out(const std::shared_ptr<RuntimeValue>& value);
+
+    		/**
+    		 * Get the process-wide null value
+    		 * @note The value is immutable and shared by every thread
+    		 */
+    		const std::shared_ptr<NullValue>& null_value();
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_ALLOCATION__
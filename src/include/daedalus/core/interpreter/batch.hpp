@@ -0,0 +1,65 @@
+#ifndef __DAEDALUS_CORE_BATCH__
+#define __DAEDALUS_CORE_BATCH__
+
+#include <daedalus/core/parser/ast.hpp>
+#include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/interpreter/compiler.hpp>
+#include <daedalus/core/tools/assert.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace interpreter {
+
+    		/**
+    		 * A column of input values, bound to the same key for every row
+    		 */
+    		typedef struct InputColumn {
+    			std::string name;
+    			std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> values;
+    			/**
+    			 * The properties the value is initialized with in the root environment
+    			 */
+    			std::unordered_map<std::string, std::string> properties;
+    		} InputColumn;
+
+    		typedef struct BatchOptions {
+    			/**
+    			 * Number of consecutive rows a worker evaluates before picking a new block
+    			 */
+    			size_t blockSize = 1024;
+    			/**
+    			 * Number of worker threads (`0` to use the hardware concurrency)
+    			 */
+    			size_t threadCount = 0;
+    		} BatchOptions;
+
+    		/**
+    		 * Evaluate a program once per row of a columnar input table
+    		 * @param interpreter The interpreter to use the configuration of
+    		 * @param program The program to evaluate
+    		 * @param inputs The input columns, all of the same length
+    		 * @param options The block and thread settings
+    		 * @return The value of the last statement of the program for each row
+    		 * @note The program is compiled once, and each worker reuses a single root environment, cleared between rows
+    		 * @note Evaluation functions must be safe to call from several threads when `threadCount` is not 1
+    		 * @note A single worker is used while the interpreter has a profiler, profilers not being thread-safe
+    		 */
+    		std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> evaluate_batch(
+    			Interpreter& interpreter,
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			const std::vector<InputColumn>& inputs,
+    			BatchOptions options = BatchOptions()
+    		);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_BATCH__
@@ -0,0 +1,80 @@
+#ifndef __DAEDALUS_CORE_COMPILER__
+#define __DAEDALUS_CORE_COMPILER__
+
+#include <daedalus/core/parser/ast.hpp>
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/tools/assert.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace interpreter {
+
+    		/**
+    		 * A scope whose statements have been compiled once
+    		 */
+    		typedef struct CompiledScope {
+    			std::vector<CompiledStatement> body;
+    			/**
+    			 * The representation of each statement, computed at compile time for the `RuntimeResult`s
+    			 */
+    			std::vector<std::string> reprs;
+    		} CompiledScope;
+
+    		/**
+    		 * Compile a statement into a pre-linked callable
+    		 * @param interpreter The interpreter to use the configuration of
+    		 * @param statement The statement to compile
+    		 * @return The compiled statement
+    		 * @note Node types without a compilation function fall back to their evaluation function, resolved once,
+    		 * the children it evaluates still going through `evaluate_statement` (type lookup included) on every evaluation
+    		 * @note Environment keys are not resolved to slots, scopes being created at runtime: compiled nodes look them up by name
+    		 */
+    		CompiledStatement compile_statement(
+    			Interpreter& interpreter,
+    			std::shared_ptr<daedalus::core::ast::Statement> statement
+    		);
+
+    		/**
+    		 * Compile every statement of a scope
+    		 * @param interpreter The interpreter to use the configuration of
+    		 * @param scope The scope to compile
+    		 * @return The compiled scope
+    		 */
+    		CompiledScope compile_scope(
+    			Interpreter& interpreter,
+    			std::shared_ptr<daedalus::core::ast::Scope> scope
+    		);
+
+    		/**
+    		 * Run a compiled scope, with the same semantics as `evaluate_scope`
+    		 * @param results The vector to fill with the results (can be `nullptr` to skip collecting them)
+    		 */
+    		RuntimeValueWrapper run_scope(
+    			Interpreter& interpreter,
+    			const CompiledScope& scope,
+    			std::vector<RuntimeResult>* results,
+    			std::shared_ptr<daedalus::core::env::Environment> scope_env = nullptr,
+    			std::shared_ptr<daedalus::core::env::Environment> parent_env = nullptr,
+    			Flags escape_flag = 0
+    		);
+
+    		/**
+    		 * Run a compiled program, with the same semantics as `interpret`
+    		 * @note Statements are not memoized, even with a `memoCache` set
+    		 */
+    		void interpret_compiled(
+    			Interpreter& interpreter,
+    			std::vector<RuntimeResult>& results,
+    			const CompiledScope& program,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    		);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_COMPILER__
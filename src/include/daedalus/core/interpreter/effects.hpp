@@ -0,0 +1,91 @@
+#ifndef __DAEDALUS_CORE_EFFECTS__
+#define __DAEDALUS_CORE_EFFECTS__
+
+#include <daedalus/core/parser/ast.hpp>
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/tools/thread_pool.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace interpreter {
+
+    		/**
+    		 * The effects of evaluating a statement, its children included
+    		 */
+    		typedef struct StatementEffects {
+    			/**
+    			 * Whether every node of the statement has declared effects and is pure
+    			 */
+    			bool pure;
+    			/**
+    			 * The keys read by the statement, sorted and without duplicates
+    			 */
+    			std::vector<std::string> reads;
+    			/**
+    			 * The keys written by the statement, sorted and without duplicates
+    			 */
+    			std::vector<std::string> writes;
+    		} StatementEffects;
+
+    		/**
+    		 * Compute the effects of a statement from the effects declared per node type
+    		 * @param interpreter The interpreter holding the declared effects
+    		 * @param statement The statement to analyze, its children being reached through `get_children`
+    		 * @return The effects of the statement (impure as soon as a node type has no declared effects or a node has hidden children)
+    		 */
+    		StatementEffects analyze_effects(
+    			Interpreter& interpreter,
+    			std::shared_ptr<daedalus::core::ast::Statement> statement
+    		);
+
+    		typedef struct ParallelScopeStats {
+    			size_t statements;
+    			/**
+    			 * Runs of consecutive statements evaluated concurrently
+    			 */
+    			size_t parallelGroups;
+    			size_t parallelStatements;
+    		} ParallelScopeStats;
+
+    		/**
+    		 * Evaluate a scope, with the same semantics as `evaluate_scope`, running independent statements concurrently
+    		 * @param pool The pool to evaluate the independent statements on, only this scope's statements being waited for
+    		 * @param stats The statistics to add to (can be `nullptr`)
+    		 * @note Only runs of consecutive pure statements writing no key are run concurrently, environments not being thread-safe to write
+    		 * @note Can be called from a task of the pool, the calling thread helping with the queued tasks while waiting
+    		 * @note Results are reported in order, and an escaping or throwing statement discards the results of the statements after it
+    		 * @note Statements are evaluated sequentially while the interpreter has a profiler, profilers not being thread-safe
+    		 */
+    		RuntimeValueWrapper evaluate_scope_parallel(
+    			Interpreter& interpreter,
+    			std::shared_ptr<daedalus::core::ast::Scope> scope,
+    			std::vector<RuntimeResult>& results,
+    			daedalus::core::tools::ThreadPool& pool,
+    			std::shared_ptr<daedalus::core::env::Environment> scope_env = nullptr,
+    			std::shared_ptr<daedalus::core::env::Environment> parent_env = nullptr,
+    			Flags escape_flag = 0,
+    			ParallelScopeStats* stats = nullptr
+    		);
+
+    		/**
+    		 * Interpret a program, with the same semantics as `interpret`, running independent top-level statements concurrently
+    		 * @param env The root environment to run in (a new one is created if `nullptr`)
+    		 */
+    		ParallelScopeStats interpret_parallel(
+    			Interpreter& interpreter,
+    			std::vector<RuntimeResult>& results,
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			daedalus::core::tools::ThreadPool& pool,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    		);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_EFFECTS__
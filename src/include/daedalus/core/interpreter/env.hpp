@@ -1,17 +1,31 @@
 #ifndef __DAEDALUS_CORE_ENV__
 #define __DAEDALUS_CORE_ENV__
 
+#include <daedalus/core/interpreter/allocation.hpp>
 #include <daedalus/core/interpreter/values.hpp>
 #include <daedalus/core/tools/assert.hpp>
+#include <daedalus/core/tools/profiler.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+/**
+ * Number of values an environment holds without allocating, searched linearly
+ * @note Past it, the values are indexed by an open-addressing hash table
+ */
+#ifndef DAE_ENV_INLINE_CAPACITY
+#define DAE_ENV_INLINE_CAPACITY 8
+#endif
+
 namespace daedalus {
 	namespace core {
 	   namespace env {
@@ -41,10 +55,133 @@ namespace daedalus {
     			std::vector<ValidationRuleSensitivity> sensitivity;
     		} EnvValidationRule;
 
+    		/**
+    		 * Environment operation counters of the calling thread
+    		 * @note An operation delegated to a parent environment is counted once, by the environment holding the key
+    		 */
+    		typedef struct EnvStats {
+    			size_t gets;
+    			size_t sets;
+    			size_t inits;
+    		} EnvStats;
+
+    		/**
+    		 * Get the environment operation counters of the calling thread
+    		 */
+    		EnvStats get_env_stats();
+
+    		/**
+    		 * A function called with the key and the new value whenever a value is set
+    		 */
+    		typedef std::function<void (const std::string& key, const std::shared_ptr<daedalus::core::values::RuntimeValue>& value)> EnvListener;
+
     		#pragma region Classes
 
+    		/**
+    		 * A value of an environment storage with its key
+    		 * @note The value lives in a block of its own, drawn from the storage's region or the per-thread pools, so entries stay small
+    		 */
+    		typedef struct EnvEntry {
+    			std::string key;
+    			EnvValue* value;
+    			/**
+    			 * The hash of the key, only computed once the storage indexes its entries
+    			 */
+    			size_t hash;
+    		} EnvEntry;
+
+    		/**
+    		 * The values held by an environment, adapting to its size
+    		 * @note The first `DAE_ENV_INLINE_CAPACITY` entries live inside the storage and are searched linearly, larger storages are indexed by an open-addressing hash table
+    		 * @note Entries keep their insertion order, inserting a key can move them but not their values
+    		 * @note The entries, the slots and the value blocks are drawn from the region installed when the storage is created, counting against its quota, keys longer than the small string buffer and property maps are still allocated from the heap
+    		 */
+    		class EnvStorage {
+    		public:
+    			EnvStorage();
+    			EnvStorage(const EnvStorage& other);
+    			~EnvStorage();
+
+    			EnvStorage& operator=(const EnvStorage&) = delete;
+
+    			/**
+    			 * Find the value of a key
+    			 * @return The value, or `nullptr` if the key is not held
+    			 */
+    			EnvValue* find(std::string_view key);
+
+    			const EnvValue* find(std::string_view key) const;
+
+    			/**
+    			 * Set the value of a key, inserting the key if needed
+    			 * @return The stored value, valid until the storage is cleared
+    			 */
+    			EnvValue& assign(std::string_view key, EnvValue value);
+
+    			size_t size() const;
+
+    			bool empty() const;
+
+    			/**
+    			 * Remove every entry, keeping the allocated capacity
+    			 */
+    			void clear();
+
+    			EnvEntry* begin();
+    			EnvEntry* end();
+    			const EnvEntry* begin() const;
+    			const EnvEntry* end() const;
+
+    		private:
+    			EnvEntry* entries;
+    			size_t count = 0;
+    			size_t capacity = DAE_ENV_INLINE_CAPACITY;
+    			/**
+    			 * The index of each entry plus one, at the slot of its hash (`0` for empty slots)
+    			 * @note Empty while the entries are searched linearly
+    			 */
+    			uint32_t* slots = nullptr;
+    			size_t slotCount = 0;
+    			/**
+    			 * The region the buffers and the values are drawn from (`nullptr` for the heap and the per-thread pools)
+    			 */
+    			std::shared_ptr<daedalus::core::values::Region> region;
+    			alignas(EnvEntry) unsigned char inlineEntries[DAE_ENV_INLINE_CAPACITY * sizeof(EnvEntry)];
+
+    			bool is_inline() const;
+
+    			template<typename T>
+    			T* allocate(size_t n);
+
+    			template<typename T>
+    			void deallocate(T* block, size_t n);
+
+    			/**
+    			 * Create a value in a block of its own
+    			 */
+    			EnvValue* make_value(EnvValue value);
+
+    			void destroy_value(EnvValue* value);
+
+    			/**
+    			 * Move the entries to a buffer twice as large
+    			 */
+    			void grow();
+
+    			/**
+    			 * Rebuild the slots for the current entries, at most half of the slots being used once the storage holds `count` entries
+    			 */
+    			void rebuild_slots(size_t count);
+
+    			/**
+    			 * Add the last entry to the slots
+    			 */
+    			void insert_slot(size_t index);
+    		};
+
     		/**
     		 * An Environment
+    		 * @note Keys are looked up as `std::string_view`, only validation rules, listeners and tracing copy them
     		 */
     		class Environment {
     		public:
@@ -56,7 +193,7 @@ namespace daedalus {
     			/**
     			 * Check whether this environment has a given key (variable / constant)
     			 */
-    			bool has_value(std::string key);
+    			bool has_value(std::string_view key);
 
     			/**
     			 * Set a value in the environment or its parents
@@ -65,7 +202,7 @@ namespace daedalus {
     			 * @return The result value
     			 */
     			std::shared_ptr<daedalus::core::values::RuntimeValue> set_value(
-    				std::string key,
+    				std::string_view key,
     				std::shared_ptr<daedalus::core::values::RuntimeValue> value
     			);
 
@@ -76,7 +213,7 @@ namespace daedalus {
     			 * @param isMutable Whether the value is mutable
     			 */
     			std::shared_ptr<daedalus::core::values::RuntimeValue> init_value(
-    				std::string key,
+    				std::string_view key,
     				std::shared_ptr<daedalus::core::values::RuntimeValue> value,
     				std::unordered_map<std::string, std::string> properties
     			);
@@ -86,7 +223,40 @@ namespace daedalus {
     			 * @param key The key of the value
     			 * @return The value
     			 */
-    			std::shared_ptr<daedalus::core::values::RuntimeValue> get_value(std::string key);
+    			std::shared_ptr<daedalus::core::values::RuntimeValue> get_value(std::string_view key);
+
+    			/**
+    			 * Set the profiler recording the environment operations (`nullptr` to disable)
+    			 * @note Child environments inherit the profiler of their parent when created
+    			 */
+    			void set_profiler(std::shared_ptr<daedalus::core::tools::Profiler> profiler);
+
+    			std::shared_ptr<daedalus::core::tools::Profiler> get_profiler();
+
+    			/**
+    			 * Register a function called after every `set_value` changing a key held by this environment
+    			 * @return The id of the listener, to remove it
+    			 * @note Listeners are kept by `clear` but not copied by `fork`
+    			 */
+    			size_t add_listener(EnvListener listener);
+
+    			void remove_listener(size_t id);
+
+    			/**
+    			 * Remove every value held by this environment, keeping its parent and configuration
+    			 * @note Allows reusing an environment between runs instead of building a new one
+    			 * @note Values shared from a forked environment are kept, the environment goes back to its state when forked
+    			 */
+    			void clear();
+
+    			/**
+    			 * Create an environment sharing the values of this one copy-on-write
+    			 * @return The forked environment, with the same parent and configuration
+    			 * @note The first write to a key in either environment copies only that entry
+    			 * @note The values are frozen on the first fork (linear), later forks are constant time until this environment is written to
+    			 * @note The parent is shared, not copied
+    			 */
+    			std::shared_ptr<Environment> fork();
 
     		private:
     			/**
@@ -96,15 +266,44 @@ namespace daedalus {
     			/**
     			 * The values held by the environment (variables / constants)
     			 */
-    			std::unordered_map<std::string, EnvValue> values;
+    			EnvStorage values;
+    			/**
+    			 * The frozen values shared with forked environments, read when a key is not in `values`
+    			 */
+    			std::shared_ptr<const EnvStorage> base = nullptr;
+
+    			/**
+    			 * Find the entry of a key, in the own values or the shared ones
+    			 * @return The entry, or `nullptr` if this environment does not hold the key
+    			 */
+    			const EnvValue* find_value(std::string_view key);
+
+    			/**
+    			 * Get the own entry of a key, copying it from the shared values if needed
+    			 */
+    			EnvValue& own_value(std::string_view key);
 
     			std::vector<std::string> envValuesProperties;
 
     			std::vector<EnvValidationRule> validationRules;
+
+    			std::shared_ptr<daedalus::core::tools::Profiler> profiler = nullptr;
+
+    			std::vector<std::pair<size_t, EnvListener>> listeners;
+    			size_t nextListenerId = 0;
     		};
 
     		#pragma endregion
 
+    		/**
+    		 * Create an environment from the region installed on the calling thread (see `RegionScope`), or from the heap
+    		 */
+    		std::shared_ptr<Environment> make_environment(
+    			std::vector<std::string> envValuesProperties,
+    			std::vector<EnvValidationRule> validationRules = std::vector<EnvValidationRule>(),
+    			std::shared_ptr<Environment> parent = nullptr
+    		);
+
 		}
 	}
 }
@@ -3,8 +3,11 @@
 
 #include <daedalus/core/parser/ast.hpp>
 #include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
 #include <daedalus/core/interpreter/env.hpp>
 #include <daedalus/core/tools/assert.hpp>
+#include <daedalus/core/tools/profiler.hpp>
+#include <daedalus/core/tools/result.hpp>
 
 #include <cstddef>
 #include <functional>
@@ -42,17 +45,90 @@ namespace daedalus {
     			std::shared_ptr<daedalus::core::env::Environment>
     		)> ParseStatementFunction;
 
+    		/**
+    		 * A statement pre-linked by `compile_statement`
+    		 * @note Executing it does not look up the node type nor cast the statement anymore
+    		 */
+    		typedef std::function<daedalus::core::interpreter::RuntimeValueWrapper (
+    			Interpreter&,
+    			const std::shared_ptr<daedalus::core::env::Environment>&
+    		)> CompiledStatement;
+
+    		/**
+    		 * The function to call once per node to turn it into a `CompiledStatement`
+    		 * @note Child nodes are expected to be compiled through `compile_statement` as well, which is what pre-links them
+    		 */
+    		typedef std::function<CompiledStatement (
+    			Interpreter&,
+    			std::shared_ptr<daedalus::core::ast::Statement>
+    		)> CompileStatementFunction;
+
+    		/**
+    		 * A function listing environment keys accessed by a node
+    		 */
+    		typedef std::function<std::vector<std::string> (std::shared_ptr<daedalus::core::ast::Statement>)> EffectKeysFunction;
+
+    		/**
+    		 * The effects of evaluating a node type, its children excluded
+    		 */
+    		typedef struct NodeEffects {
+    			/**
+    			 * Whether the node has no effect besides the keys it writes (no I/O, no hidden state)
+    			 */
+    			bool pure;
+    			/**
+    			 * The keys the node reads (`nullptr` for none)
+    			 */
+    			EffectKeysFunction reads;
+    			/**
+    			 * The keys the node declares or assigns (`nullptr` for none)
+    			 */
+    			EffectKeysFunction writes;
+    			/**
+    			 * Whether results of the node are cached in the interpreter's `memoCache`, for expensive pure nodes
+    			 */
+    			bool memoize;
+    		} NodeEffects;
+
+    		NodeEffects make_node_effects(
+    			bool pure = true,
+    			EffectKeysFunction reads = nullptr,
+    			EffectKeysFunction writes = nullptr,
+    			bool memoize = false
+    		);
+
+    		class MemoCache;
+
     		typedef struct Interpreter {
     			std::unordered_map<std::string, ParseStatementFunction> nodeEvaluationFunctions;
     			std::vector<std::string> envValuesProperties;
     			std::vector<daedalus::core::env::EnvValidationRule> validationRules;
+    			/**
+    			 * Optional compilation functions, node types without one are compiled from their evaluation function
+    			 */
+    			std::unordered_map<std::string, CompileStatementFunction> nodeCompilationFunctions;
+    			/**
+    			 * The profiler recording evaluations per node type (`nullptr` when profiling is disabled)
+    			 * @note Statements compiled while it is `nullptr` are never profiled
+    			 */
+    			std::shared_ptr<daedalus::core::tools::Profiler> profiler = nullptr;
+    			/**
+    			 * The declared effects per node type, node types without any being assumed impure (see `effects.hpp`)
+    			 */
+    			std::unordered_map<std::string, NodeEffects> nodeEffects;
+    			/**
+    			 * The cache of the results of memoized nodes (`nullptr` to disable, see `memo.hpp`)
+    			 * @note Only `evaluate_statement` goes through it, compiled statements are not memoized
+    			 */
+    			std::shared_ptr<MemoCache> memoCache = nullptr;
     		} Interpreter;
 
     		void setup_interpreter(
     			Interpreter& interpreter,
     			std::unordered_map<std::string, ParseStatementFunction> nodeEvaluationFunctions,
     			std::vector<std::string> envValuesProperties,
-    			std::vector<daedalus::core::env::EnvValidationRule> validationRules
+    			std::vector<daedalus::core::env::EnvValidationRule> validationRules,
+    			std::unordered_map<std::string, CompileStatementFunction> nodeCompilationFunctions = std::unordered_map<std::string, CompileStatementFunction>()
     		);
 
             typedef struct RuntimeResult {
@@ -75,10 +151,47 @@ namespace daedalus {
                 Flags escape_flag = 0
     		);
 
+    		/**
+    		 * Interpret a program
+    		 * @param env The root environment to run in (a new one is created if `nullptr`), e.g. a fork of a prelude environment
+    		 * @note Every node goes through `evaluate_statement`, programs run many times can be compiled once instead (see `compiler.hpp`)
+    		 */
     		void interpret(
     			Interpreter& interpreter,
     			std::vector<RuntimeResult>& results,
-    			std::shared_ptr<daedalus::core::ast::Scope> program
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    		);
+
+    		/**
+    		 * Interpret a program, its values and environments being allocated from a region released at the end of the run
+    		 * @param quota Maximum number of bytes allocated from the region (`0` for no limit)
+    		 * @note The quota bounds the values, the environments and their storages, the strings and property maps they hold being allocated from the heap
+    		 * @param env The root environment to run in (a new one is created in the region if `nullptr`)
+    		 * @return The statistics of the region
+    		 * @throw daedalus::core::values::QuotaExceeded if the run exceeds the quota, the results before it being kept
+    		 * @note Values stored in an environment outliving the run pin the region, use `copy_out` to keep them instead
+    		 */
+    		daedalus::core::values::RegionStats interpret_in_region(
+    			Interpreter& interpreter,
+    			std::vector<RuntimeResult>& results,
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			size_t quota,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    		);
+
+    		/**
+    		 * Interpret a program, without throwing on evaluation errors
+    		 * @param env The root environment to run in (a new one is created if `nullptr`)
+    		 * @return The error and the index of the top-level statement it was raised in, the results before it being kept
+    		 * @note Errors thrown by evaluation functions are caught and converted into `EVALUATION_ERROR`s
+    		 * @note Runs the same loop as `interpret`, the results of both being the same up to the first error
+    		 */
+    		daedalus::core::tools::Result<void> try_interpret(
+    			Interpreter& interpreter,
+    			std::vector<RuntimeResult>& results,
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			std::shared_ptr<daedalus::core::env::Environment> env = nullptr
     		);
     	}
     }
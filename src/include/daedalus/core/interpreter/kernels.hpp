@@ -0,0 +1,105 @@
+#ifndef __DAEDALUS_CORE_KERNELS__
+#define __DAEDALUS_CORE_KERNELS__
+
+#include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <daedalus/core/tools/assert.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace daedalus {
+    namespace core {
+    	namespace kernels {
+
+    		/**
+    		 * An elementwise operation
+    		 * @note Comparisons produce `1` where true and `0` where false
+    		 */
+    		enum class VectorOperation {
+    			ADD,
+    			SUB,
+    			MUL,
+    			DIV,
+    			LT,
+    			LE,
+    			GT,
+    			GE,
+    			EQ,
+    			NE
+    		};
+
+    		enum class VectorReduction {
+    			SUM,
+    			MIN,
+    			MAX
+    		};
+
+    		enum class KernelBackend {
+    			/**
+    			 * Use the fastest backend supported by the CPU
+    			 */
+    			AUTO,
+    			SCALAR,
+    			AVX2
+    		};
+
+    		/**
+    		 * Force the backend used by the kernels
+    		 * @param backend The backend to use
+    		 * @note Asking for AVX2 on a CPU not supporting it falls back to the scalar backend
+    		 */
+    		void set_backend(KernelBackend backend);
+
+    		/**
+    		 * Get the backend the kernels currently run with (never `AUTO`)
+    		 */
+    		KernelBackend get_backend();
+
+    		/**
+    		 * Apply an operation elementwise on two arrays
+    		 * @param out The output array, can alias `left` or `right`
+    		 */
+    		void apply(VectorOperation operation, const double* left, const double* right, double* out, size_t size);
+
+    		/**
+    		 * Apply an operation between each element of an array and a scalar
+    		 * @param scalarOnLeft Whether the scalar is the left operand
+    		 */
+    		void apply_scalar(VectorOperation operation, const double* vector, double scalar, bool scalarOnLeft, double* out, size_t size);
+
+    		/**
+    		 * Reduce an array to a single number
+    		 * @note The SIMD backend reassociates additions, so sums may differ from the scalar backend in the last bits
+    		 * @note The minimum of an empty array is `+inf`, its maximum `-inf`
+    		 */
+    		double reduce(VectorReduction reduction, const double* vector, size_t size);
+
+    		/**
+    		 * Hook for operator evaluators: apply an operation if one of the operands is a `NumberVectorValue`
+    		 * @param operation The operation to apply
+    		 * @param left The left operand (`NumberVectorValue` or `NumberValue`, broadcast)
+    		 * @param right The right operand (`NumberVectorValue` or `NumberValue`, broadcast)
+    		 * @return The resulting `NumberVectorValue`, or `nullptr` if no operand is a vector so the evaluator can run its scalar path
+    		 */
+    		std::shared_ptr<daedalus::core::values::RuntimeValue> apply_vector_operation(
+    			VectorOperation operation,
+    			std::shared_ptr<daedalus::core::values::RuntimeValue> left,
+    			std::shared_ptr<daedalus::core::values::RuntimeValue> right
+    		);
+
+    		/**
+    		 * Hook for reduction evaluators: reduce a `NumberVectorValue`
+    		 * @return The resulting `NumberValue`, or `nullptr` if the operand is not a vector
+    		 */
+    		std::shared_ptr<daedalus::core::values::RuntimeValue> apply_vector_reduction(
+    			VectorReduction reduction,
+    			std::shared_ptr<daedalus::core::values::RuntimeValue> vector
+    		);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_KERNELS__
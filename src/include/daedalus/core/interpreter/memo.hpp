@@ -0,0 +1,137 @@
+#ifndef __DAEDALUS_CORE_MEMO__
+#define __DAEDALUS_CORE_MEMO__
+
+#include <daedalus/core/parser/ast.hpp>
+#include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/interpreter.hpp>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace interpreter {
+
+    		typedef struct MemoCacheOptions {
+    			/**
+    			 * Maximum number of cached results, the least recently used being evicted first
+    			 */
+    			size_t maxEntries = 4096;
+    		} MemoCacheOptions;
+
+    		typedef struct MemoCacheStats {
+    			size_t hits;
+    			size_t misses;
+    			size_t evictions;
+    			/**
+    			 * Entries dropped because a key they read was set
+    			 */
+    			size_t invalidations;
+    			size_t entries;
+    		} MemoCacheStats;
+
+    		/**
+    		 * Get the ratio of lookups served from the cache (`0` before any lookup)
+    		 */
+    		double hit_rate(const MemoCacheStats& stats);
+
+    		/**
+    		 * A thread-safe cache of the results of pure nodes, keyed by node identity and the values of the keys they read
+    		 * @note Node types opt in through `NodeEffects::memoize`, a node is only cached when the whole statement is pure and writes nothing (see `analyze_effects`)
+    		 * @note Values are compared with `RuntimeValue::hash` and `RuntimeValue::equals`, cached results are shared between hits
+    		 */
+    		class MemoCache : public std::enable_shared_from_this<MemoCache> {
+    		public:
+    			MemoCache(MemoCacheOptions options = MemoCacheOptions());
+
+    			/**
+    			 * Get the result of a node, evaluating it on a miss
+    			 * @param evaluate The evaluation function of the node
+    			 */
+    			RuntimeValueWrapper evaluate(
+    				Interpreter& interpreter,
+    				std::shared_ptr<daedalus::core::ast::Statement> statement,
+    				std::shared_ptr<daedalus::core::env::Environment> env,
+    				const ParseStatementFunction& evaluate
+    			);
+
+    			/**
+    			 * Drop the cached results reading a key whenever it is set in an environment
+    			 * @note `interpret` watches its root environment, watching an environment twice has no effect
+    			 */
+    			void watch(std::shared_ptr<daedalus::core::env::Environment> env);
+
+    			/**
+    			 * Drop the cached results reading a key
+    			 */
+    			void invalidate(const std::string& key);
+
+    			/**
+    			 * Drop every cached result (the statistics are kept)
+    			 */
+    			void clear();
+
+    			MemoCacheStats get_stats();
+
+    		private:
+    			typedef struct Entry {
+    				std::shared_ptr<daedalus::core::ast::Statement> node;
+    				std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>> arguments;
+    				/**
+    				 * The hashes of the arguments when cached, so values changed in place are not matched anymore
+    				 */
+    				std::vector<size_t> argumentHashes;
+    				size_t hash;
+    				RuntimeValueWrapper result;
+    			} Entry;
+
+    			/**
+    			 * The analysis of a node, done once per node
+    			 */
+    			typedef struct NodeInfo {
+    				/**
+    				 * The analyzed node, not kept alive by its analysis
+    				 */
+    				std::weak_ptr<daedalus::core::ast::Statement> node;
+    				bool cacheable;
+    				std::vector<std::string> reads;
+    			} NodeInfo;
+
+    			NodeInfo& get_node_info(Interpreter& interpreter, const std::shared_ptr<daedalus::core::ast::Statement>& statement);
+
+    			std::list<Entry>::iterator find(
+    				const std::shared_ptr<daedalus::core::ast::Statement>& statement,
+    				const std::vector<std::shared_ptr<daedalus::core::values::RuntimeValue>>& arguments,
+    				const std::vector<size_t>& argumentHashes,
+    				size_t hash
+    			);
+
+    			void erase(std::list<Entry>::iterator entry);
+
+    			MemoCacheOptions options;
+    			std::mutex mutex;
+    			/**
+    			 * The cached results, the most recently used first
+    			 */
+    			std::list<Entry> entries;
+    			std::unordered_multimap<size_t, std::list<Entry>::iterator> entriesByHash;
+    			std::unordered_multimap<std::string, std::list<Entry>::iterator> entriesByKey;
+    			std::unordered_map<daedalus::core::ast::Statement*, NodeInfo> nodes;
+    			/**
+    			 * The number of analyzed nodes from which the analyses of freed nodes are dropped
+    			 */
+    			size_t pruneNodesAt;
+    			std::vector<std::weak_ptr<daedalus::core::env::Environment>> watched;
+    			MemoCacheStats stats;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_MEMO__
@@ -0,0 +1,110 @@
+#ifndef __DAEDALUS_CORE_SPECIALIZE__
+#define __DAEDALUS_CORE_SPECIALIZE__
+
+#include <daedalus/core/interpreter/values.hpp>
+#include <daedalus/core/interpreter/allocation.hpp>
+#include <daedalus/core/interpreter/env.hpp>
+#include <daedalus/core/interpreter/interpreter.hpp>
+#include <daedalus/core/tools/assert.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+/**
+ * The maximum number of operands a specializing node can have
+ */
+#define DAE_SPECIALIZATION_MAX_OPERANDS 4
+
+namespace daedalus {
+    namespace core {
+    	namespace interpreter {
+
+    		/**
+    		 * A function evaluating a node from the values of its operands
+    		 * @param interpreter The interpreter
+    		 * @param operands The operand values, in the order the operands were given
+    		 */
+    		typedef std::function<RuntimeValueWrapper (
+    			Interpreter& interpreter,
+    			const std::shared_ptr<daedalus::core::values::RuntimeValue>* operands
+    		)> OperandsFunction;
+
+    		/**
+    		 * A fast path for a given combination of operand types
+    		 */
+    		typedef struct Specialization {
+    			/**
+    			 * The exact dynamic type expected for each operand
+    			 */
+    			std::vector<std::type_index> operandTypes;
+    			/**
+    			 * The function to run once the guards passed, operands can be `static_cast` safely
+    			 */
+    			OperandsFunction fastPath;
+    		} Specialization;
+
+    		/**
+    		 * The runtime type feedback of a specializing node
+    		 * @note Only updated outside of the specialized path, with relaxed atomics
+    		 */
+    		typedef struct SpecializationFeedback {
+    			/**
+    			 * Index of the installed specialization, `-1` when running generically, `-2` once given up
+    			 */
+    			std::atomic<int> active = -1;
+    			/**
+    			 * Index of the specialization matching the last observed operand types
+    			 */
+    			std::atomic<int> candidate = -1;
+    			/**
+    			 * Number of consecutive observations of `candidate`
+    			 */
+    			std::atomic<size_t> streak = 0;
+    			std::atomic<size_t> deoptimizations = 0;
+    		} SpecializationFeedback;
+
+    		typedef struct SpecializationOptions {
+    			/**
+    			 * Number of consecutive matching observations before a specialization is installed
+    			 */
+    			size_t warmup = 8;
+    			/**
+    			 * Number of deoptimizations after which the node stays generic for good
+    			 */
+    			size_t maxDeoptimizations = 4;
+    		} SpecializationOptions;
+
+    		/**
+    		 * Create a compiled node rewriting itself from the types of its operands
+    		 * @param operands The compiled operands, evaluated in order before the node
+    		 * @param generic The evaluator handling any operand types
+    		 * @param specializations The fast paths the node can switch to
+    		 * @param options The warmup and deoptimization settings
+    		 * @param feedback The feedback to record into (created if `nullptr`)
+    		 * @return The compiled node
+    		 * @note A specialization is installed once its operand types have been observed `warmup` times in a row,
+    		 * and removed as soon as its guards fail
+    		 */
+    		CompiledStatement make_specializing_node(
+    			std::vector<CompiledStatement> operands,
+    			OperandsFunction generic,
+    			std::vector<Specialization> specializations,
+    			SpecializationOptions options = SpecializationOptions(),
+    			std::shared_ptr<SpecializationFeedback> feedback = nullptr
+    		);
+
+    		/**
+    		 * Create a specialization for two `NumberValue` operands
+    		 * @param operation The operation to apply on the raw numbers
+    		 * @return The specialization
+    		 */
+    		Specialization make_number_specialization(double (*operation)(double, double));
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_SPECIALIZE__
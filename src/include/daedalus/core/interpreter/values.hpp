@@ -1,7 +1,12 @@
 #ifndef __DAEDALUS_CORE_VALUES__
 #define __DAEDALUS_CORE_VALUES__
 
+#include <daedalus/core/tools/aligned_allocator.hpp>
+
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace daedalus {
     namespace core {
@@ -31,6 +36,25 @@ namespace daedalus {
     			 * Checks whether the value is true or false
     			 */
     			virtual bool IsTrue();
+
+    			/**
+    			 * Create an independent copy of the value
+    			 * @note Custom values should override it to be copied out of a region (see `copy_out`)
+    			 * @throw std::runtime_error if the value cannot be copied
+    			 */
+    			virtual std::shared_ptr<RuntimeValue> copy();
+
+    			/**
+    			 * Get a hash of the content of the value, consistent with `equals`
+    			 * @note The default hashes the identity of the value
+    			 */
+    			virtual size_t hash();
+
+    			/**
+    			 * Check whether two values have the same content
+    			 * @note The default compares identities, custom values should override both `hash` and `equals` to be memoized by content
+    			 */
+    			virtual bool equals(const std::shared_ptr<RuntimeValue>& other);
     		};
 
     		/**
@@ -48,6 +72,12 @@ namespace daedalus {
     			virtual std::string repr() override;
 
     			virtual bool IsTrue() override;
+
+    			virtual std::shared_ptr<RuntimeValue> copy() override;
+
+    			virtual size_t hash() override;
+
+    			virtual bool equals(const std::shared_ptr<RuntimeValue>& other) override;
     		};
 
     		/**
@@ -68,10 +98,56 @@ namespace daedalus {
 
     			virtual bool IsTrue() override;
 
+    			virtual std::shared_ptr<RuntimeValue> copy() override;
+
+    			virtual size_t hash() override;
+
+    			virtual bool equals(const std::shared_ptr<RuntimeValue>& other) override;
+
     		private:
     			double value;
     		};
 
+    		/**
+    		 * NumberVectorValue < RuntimeValue
+    		 * @note Backed by contiguous storage aligned for SIMD kernels (see `kernels.hpp`)
+    		 */
+    		class NumberVectorValue: public RuntimeValue {
+    		public:
+    			typedef std::vector<double, daedalus::core::tools::AlignedAllocator<double, 32>> Storage;
+
+    			/**
+    			 * Create a new Number Vector Value
+    			 * @param size The number of elements
+    			 * @param fill The value of every element
+    			 */
+    			NumberVectorValue(size_t size = 0, double fill = 0);
+
+    			/**
+    			 * Create a new Number Vector Value from existing storage
+    			 */
+    			NumberVectorValue(Storage values);
+
+    			Storage& get();
+
+    			size_t size();
+
+    			virtual std::string type() override;
+
+    			virtual std::string repr() override;
+
+    			virtual bool IsTrue() override;
+
+    			virtual std::shared_ptr<RuntimeValue> copy() override;
+
+    			virtual size_t hash() override;
+
+    			virtual bool equals(const std::shared_ptr<RuntimeValue>& other) override;
+
+    		private:
+    			Storage values;
+    		};
+
     		#pragma endregion
 
     	}
@@ -2,12 +2,16 @@
 #define __DAEDALUS_CORE_LEXER__
 
 #include <daedalus/core/tools/assert.hpp>
+#include <daedalus/core/tools/result.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <stdexcept>
+#include <variant>
 #include <vector>
 
 /**
@@ -41,12 +45,34 @@
  * @param substr The substring to look for
  * @return Whether `str` starts with `substr`
  */
-bool startswith(std::string str, std::string substr);
+bool startswith(const std::string& str, const std::string& substr);
 
 namespace daedalus {
     namespace core {
     	namespace lexer {
 
+    		typedef struct Lexer Lexer;
+
+    		/**
+    		 * The id of a string in the process-wide intern table
+    		 */
+    		typedef struct InternedString {
+    			uint32_t id;
+
+    			bool operator==(const InternedString& other) const {
+    				return this->id == other.id;
+    			}
+
+    			bool operator!=(const InternedString& other) const {
+    				return this->id != other.id;
+    			}
+    		} InternedString;
+
+    		/**
+    		 * A value computed once by the lexer, so the parser does not have to read the token text again
+    		 */
+    		typedef std::variant<std::monostate, double, int64_t, InternedString> TokenPayload;
+
     		typedef struct TokenType {
     			std::string name;
     			/**
@@ -55,8 +81,25 @@ namespace daedalus {
     			 * @return The value of the lexed token (or an empty string if the token is not found)
     			 */
     			std::function<std::string (std::string src)> lex_token;
+    			/**
+    			 * The function to call to lex the token with a payload, used instead of `lex_token` when set
+    			 * @param lexer The lexer lexing the token
+    			 * @param src The source string to lex
+    			 * @param payload The payload to fill
+    			 * @return The length of the lexed token (or `0` if the token is not found)
+    			 */
+    			std::function<size_t (const Lexer& lexer, std::string_view src, TokenPayload& payload)> lex_typed_token = nullptr;
     		} TokenType;
 
+    		/**
+    		 * A function matching every token type of a set at once, as generated by `StaticTokenSet`
+    		 * @param src The source string to lex
+    		 * @param name The name of the matched token type
+    		 * @param payload The payload to fill
+    		 * @return The length of the lexed token (or `0` if no token is found)
+    		 */
+    		typedef size_t (*StaticMatcher)(std::string_view src, std::string_view& name, TokenPayload& payload);
+
     		/**
     		 * A lexer configuration
     		 */
@@ -74,6 +117,10 @@ namespace daedalus {
     			char charDelimiter = '\'';
     			char stringDelimiter = '"';
     			char escapeCharacter = '\\';
+    			/**
+    			 * The token types known at compile time, tried before `tokenTypes` (`nullptr` if none)
+    			 */
+    			StaticMatcher staticMatcher = nullptr;
     		} Lexer;
 
     		/**
@@ -82,8 +129,24 @@ namespace daedalus {
     		typedef struct Token {
     			std::string type;
     			std::string value;
+    			TokenPayload payload = TokenPayload();
+    			/**
+    			 * The offset of the token in the source string
+    			 */
+    			size_t offset = 0;
     		} Token;
 
+    		/**
+    		 * Get the id of a string, adding it to the intern table if needed
+    		 * @note The intern table is shared by every thread and never shrinks
+    		 */
+    		InternedString intern(const std::string& str);
+
+    		/**
+    		 * Get the string an id was interned from
+    		 */
+    		const std::string& get_interned(InternedString interned);
+
     		/**
     		 * Get the string representation of a token
     		 * @param token The token to get the representation of
@@ -111,9 +174,45 @@ namespace daedalus {
     		 * @param name The name of the token
     		 * @param lex_token The function to run to lex the token
     		 * @return The created token
+    		 * @note `lex_token` receives a copy of the remaining source for every token, prefer the `std::string_view` overload
     		 */
     		TokenType make_token_type(std::string name, std::function<std::string(std::string)> lex_token);
 
+    		/**
+    		 * Create a token with a name and a lexing function reading the source in place
+    		 * @param name The name of the token
+    		 * @param lex_token The function to run to lex the token, returning its length (or `0` if the token is not found)
+    		 * @return The created token
+    		 */
+    		TokenType make_token_type(std::string name, std::function<size_t(std::string_view)> lex_token);
+
+    		/**
+    		 * Create a token lexing numeric literals (`12`, `1.5`, `2e-3`), with the lexer's `decimalSeparator`
+    		 * @param name The name of the token
+    		 * @param decimalSeparator The separator used by `lex_token`, which has no lexer to read it from
+    		 * @return The created token
+    		 * @note The payload holds an `int64_t` for integers fitting in one, a `double` otherwise
+    		 */
+    		TokenType make_number_token_type(std::string name = "NUMBER", char decimalSeparator = '.');
+
+    		/**
+    		 * Create a token with a name and a lexing function, its value being interned into the payload
+    		 * @param name The name of the token
+    		 * @param lex_token The function to run to lex the token
+    		 * @return The created token
+    		 * @note Meant for identifiers, compared through their `InternedString` instead of their text
+    		 * @note `lex_token` receives a copy of the remaining source for every token, prefer the `std::string_view` overload
+    		 */
+    		TokenType make_interned_token_type(std::string name, std::function<std::string(std::string)> lex_token);
+
+    		/**
+    		 * Create a token with a name and a lexing function reading the source in place, its value being interned into the payload
+    		 * @param name The name of the token
+    		 * @param lex_token The function to run to lex the token, returning its length (or `0` if the token is not found)
+    		 * @return The created token
+    		 */
+    		TokenType make_interned_token_type(std::string name, std::function<size_t(std::string_view)> lex_token);
+
     		/**
     		 * Update the configuration of a lexer
     		 */
@@ -145,6 +244,37 @@ namespace daedalus {
     			std::vector<Token>& tokens,
     			std::string src
     		);
+
+    		/**
+    		 * A function receiving the tokens as soon as they are lexed
+    		 */
+    		typedef std::function<void (Token token)> TokenCallback;
+
+    		/**
+    		 * Lex a source string, handing each token over as soon as it is lexed
+    		 * @param lexer The lexer to use the configuation of
+    		 * @param onToken The function to call with each token, `EOF` included
+    		 * @param src The source string
+    		 */
+    		void lex_stream(
+    			Lexer& lexer,
+    			TokenCallback onToken,
+    			std::string src
+    		);
+
+    		/**
+    		 * Lex a source string into a vector of tokens, without throwing on lexing errors
+    		 * @param lexer The lexer to use the configuation of
+    		 * @param tokens A reference to the vector of tokens to fill
+    		 * @param src The source string
+    		 * @return The error and its offset if the source could not be lexed, the tokens before it being kept
+    		 * @note Errors thrown by the token lexing functions themselves are not caught
+    		 */
+    		daedalus::core::tools::Result<void> try_lex(
+    			Lexer& lexer,
+    			std::vector<Token>& tokens,
+    			const std::string& src
+    		);
     	}
     }
 }
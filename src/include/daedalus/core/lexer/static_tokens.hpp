@@ -0,0 +1,134 @@
+#ifndef __DAEDALUS_CORE_STATIC_TOKENS__
+#define __DAEDALUS_CORE_STATIC_TOKENS__
+
+#include <daedalus/core/lexer/lexer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Declare a static token type matching a literal
+ * @param Type The name of the declared type
+ * @param tokenName The name of the lexed tokens
+ * @param tokenValue The literal to match
+ */
+#define DAE_STATIC_TOKEN(Type, tokenName, tokenValue) \
+struct Type { \
+	static constexpr std::string_view name = tokenName; \
+	static constexpr std::string_view value = tokenValue; \
+	static size_t match(std::string_view src, daedalus::core::lexer::TokenPayload&) { \
+		return daedalus::core::lexer::match_literal(src, value); \
+	} \
+};
+
+namespace daedalus {
+    namespace core {
+    	namespace lexer {
+
+    		/**
+    		 * Match a literal at the start of a source string
+    		 * @return The length of the literal if `src` starts with it, `0` otherwise
+    		 */
+    		constexpr size_t match_literal(std::string_view src, std::string_view literal) {
+    			return src.substr(0, literal.length()) == literal ? literal.length() : 0;
+    		}
+
+    		/**
+    		 * A set of token types known at compile time, tried in declaration order
+    		 * @note Each token type is a type with a `static constexpr std::string_view name` and a `static size_t match(std::string_view src, TokenPayload& payload)` returning the matched length.
+    		 * Literals (`DAE_STATIC_TOKEN`) also declare their `value`, and other token types can declare the bytes they start with as `static constexpr std::string_view firstBytes`,
+    		 * so only the token types able to start with the next byte are tried
+    		 */
+    		template<typename... Tokens>
+    		class StaticTokenSet {
+    		public:
+    			static_assert(sizeof...(Tokens) <= 64, "A static token set holds 64 token types at most");
+
+    			/**
+    			 * Match the next token, with the signature of a `StaticMatcher`
+    			 */
+    			static size_t match(std::string_view src, std::string_view& name, TokenPayload& payload) {
+    				if(src.empty()) {
+    					return 0;
+    				}
+    				return match_candidates(
+    					src,
+    					name,
+    					payload,
+    					FIRST_BYTES[static_cast<unsigned char>(src[0])],
+    					std::index_sequence_for<Tokens...>()
+    				);
+    			}
+
+    		private:
+    			template<typename Token, typename = void>
+    			struct HasValue : std::false_type {};
+
+    			template<typename Token>
+    			struct HasValue<Token, std::void_t<decltype(Token::value)>> : std::true_type {};
+
+    			template<typename Token, typename = void>
+    			struct HasFirstBytes : std::false_type {};
+
+    			template<typename Token>
+    			struct HasFirstBytes<Token, std::void_t<decltype(Token::firstBytes)>> : std::true_type {};
+
+    			template<typename Token>
+    			static constexpr void add_first_bytes(std::array<uint64_t, 256>& table, size_t index) {
+    				uint64_t bit = uint64_t(1) << index;
+    				if constexpr(HasValue<Token>::value) {
+    					table[static_cast<unsigned char>(Token::value[0])] |= bit;
+    				} else if constexpr(HasFirstBytes<Token>::value) {
+    					for(char c : Token::firstBytes) {
+    						table[static_cast<unsigned char>(c)] |= bit;
+    					}
+    				} else {
+    					for(uint64_t& candidates : table) {
+    						candidates |= bit;
+    					}
+    				}
+    			}
+
+    			template<size_t... I>
+    			static constexpr std::array<uint64_t, 256> make_first_bytes(std::index_sequence<I...>) {
+    				std::array<uint64_t, 256> table = {};
+    				(add_first_bytes<Tokens>(table, I), ...);
+    				return table;
+    			}
+
+    			/**
+    			 * The token types able to start with each byte, one bit per token type
+    			 */
+    			static constexpr std::array<uint64_t, 256> FIRST_BYTES = make_first_bytes(std::index_sequence_for<Tokens...>());
+
+    			template<size_t... I>
+    			static size_t match_candidates(
+    				std::string_view src,
+    				std::string_view& name,
+    				TokenPayload& payload,
+    				uint64_t candidates,
+    				std::index_sequence<I...>
+    			) {
+    				size_t length = 0;
+    				(void)(((((candidates >> I) & 1) != 0 && (length = Tokens::match(src, payload)) != 0 && (name = Tokens::name, true)) || ...));
+    				return length;
+    			}
+    		};
+
+    		/**
+    		 * Make a lexer try a static token set before its runtime token types
+    		 * @param lexer The lexer to update
+    		 */
+    		template<typename TokenSet>
+    		void use_static_tokens(Lexer& lexer) {
+    			lexer.staticMatcher = &TokenSet::match;
+    		}
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_STATIC_TOKENS__
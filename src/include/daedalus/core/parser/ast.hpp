@@ -1,12 +1,17 @@
 #ifndef __DAEDALUS_CORE_AST__
 #define __DAEDALUS_CORE_AST__
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace daedalus {
     namespace core {
+        namespace values {
+            class RuntimeValue;
+        }
+
         namespace ast {
 
     		class Statement;
@@ -30,6 +35,24 @@ namespace daedalus {
     			 * Get the string representation of the Statement
     			 */
     			virtual std::string repr(int indent = 0);
+
+    			/**
+    			 * Get the direct children of the Statement
+    			 * @note Custom nodes holding other nodes should override it so tree-walking passes can reach them
+    			 */
+    			virtual std::vector<std::shared_ptr<Expression>> get_children();
+
+    			/**
+    			 * Whether the Statement holds children `get_children` cannot list yet (an unparsed body)
+    			 * @note Tree-walking analyses must assume the worst of such a Statement
+    			 */
+    			virtual bool has_hidden_children();
+
+    			/**
+    			 * Get the approximate memory used by the Statement itself, children excluded
+    			 * @note Custom nodes should override it to report their own size
+    			 */
+    			virtual size_t get_footprint();
     		};
 
     		/**
@@ -42,8 +65,30 @@ namespace daedalus {
     			 * Get the constexpr version of the node (can be evaluated by parser)
     			 */
     			virtual std::shared_ptr<Expression> get_constexpr();
+
+    			/**
+    			 * Whether the Expression is immutable, so identical subtrees can share it
+    			 * @note Custom nodes opting in should also override `get_structural_hash` and `structurally_equals`
+    			 */
+    			virtual bool is_internable();
+
+    			/**
+    			 * Get the hash of the node kind, its own fields and its children
+    			 */
+    			virtual size_t get_structural_hash();
+
+    			/**
+    			 * Check if the Expression is structurally equal to another one
+    			 * @note Children can be compared by identity, trees being interned bottom-up
+    			 */
+    			virtual bool structurally_equals(const std::shared_ptr<Expression>& other);
     		};
 
+    		/**
+    		 * Combine a hash with another value, to build structural hashes
+    		 */
+    		size_t hash_combine(size_t seed, size_t value);
+
             /**
     		 * Scope < Statement
     		 * @note This class is only used for inheritance purpose or as a general wrapper for a program
@@ -52,12 +97,18 @@ namespace daedalus {
     		public:
     			Scope(std::vector<std::shared_ptr<Expression>> body = std::vector<std::shared_ptr<Expression>>());
 
-                std::vector<std::shared_ptr<Expression>> get_body();
+                /**
+                 * Get the statements of the Scope
+                 * @note Scopes parsed lazily resolve their body on the first call
+                 */
+                virtual std::vector<std::shared_ptr<Expression>> get_body();
                 void push_back_body(std::shared_ptr<Expression> expression);
 
     			virtual std::string type() override;
                 virtual std::shared_ptr<Expression> get_constexpr() override;
     			virtual std::string repr(int indent = 0) override;
+    			virtual std::vector<std::shared_ptr<Expression>> get_children() override;
+    			virtual size_t get_footprint() override;
 
             protected:
                 std::vector<std::shared_ptr<Expression>> body;
@@ -72,14 +123,27 @@ namespace daedalus {
     			NumberExpression(double value);
 
                 double get_value();
+                /**
+                 * @note Interned literals are shared, use a new NumberExpression instead of changing their value
+                 */
                 void set_value(double value);
 
+                /**
+                 * Get the runtime value of the literal, created once so evaluating it allocates nothing
+                 */
+                std::shared_ptr<daedalus::core::values::RuntimeValue> get_constant();
+
     			virtual std::string type() override;
     			virtual std::shared_ptr<Expression> get_constexpr() override;
     			virtual std::string repr(int indent = 0) override;
+    			virtual size_t get_footprint() override;
+    			virtual bool is_internable() override;
+    			virtual size_t get_structural_hash() override;
+    			virtual bool structurally_equals(const std::shared_ptr<Expression>& other) override;
 
             protected:
     			double value;
+    			std::shared_ptr<daedalus::core::values::RuntimeValue> constant;
     		};
     	}
     }
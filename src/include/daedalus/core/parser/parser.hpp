@@ -5,9 +5,11 @@
 #include <daedalus/core/parser/ast.hpp>
 #include <daedalus/core/tools/assert.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <functional>
 
@@ -32,11 +34,110 @@ namespace daedalus {
 
     		enum class ParserFlags {
     			OPTI_CONST_EXPR,
+    			/**
+    			 * Scopes parsed with `parse_scope` only keep their tokens until their body is needed
+    			 */
+    			LAZY_SCOPES,
+    			/**
+    			 * Literals and top-level statements are hash-consed through the parser's `NodePool`
+    			 */
+    			INTERN_NODES,
+    		};
+
+    		typedef struct NodePoolStats {
+    			size_t lookups;
+    			size_t hits;
+    			/**
+    			 * Nodes currently held by the pool (expired ones included until pruned)
+    			 */
+    			size_t entries;
+    		} NodePoolStats;
+
+    		/**
+    		 * A thread-safe pool of immutable nodes, sharing structurally equal subtrees
+    		 * @note The pool does not keep nodes alive, expired nodes being pruned whenever the pool doubles in size
+    		 */
+    		class NodePool {
+    		public:
+    			NodePool();
+
+    			/**
+    			 * Get the pooled node structurally equal to a node, pooling it if there is none
+    			 * @param node The node to intern (returned as is if it is not internable)
+    			 * @return The shared node
+    			 */
+    			std::shared_ptr<daedalus::core::ast::Expression> intern(std::shared_ptr<daedalus::core::ast::Expression> node);
+
+    			NodePoolStats get_stats();
+
+    			void clear();
+
+    		private:
+    			std::mutex mutex;
+    			std::unordered_multimap<size_t, std::weak_ptr<daedalus::core::ast::Expression>> nodes;
+    			/**
+    			 * Number of nodes at which the expired ones are pruned
+    			 */
+    			size_t pruneAt;
+    			NodePoolStats stats;
     		};
 
     		struct Parser {
     			std::unordered_map<std::string, Node> nodesRegister;
     			std::vector<ParserFlags> flags;
+    			/**
+    			 * The pool used when `INTERN_NODES` is set, shared by the copies of the parser
+    			 * @note Created by `get_node_pool`, parsers not interning nodes having none
+    			 */
+    			std::shared_ptr<NodePool> nodePool = nullptr;
+    			/**
+    			 * The decimal separator of `NUMBER` tokens without payload, set to the lexer's by `setup_daedalus`
+    			 */
+    			char decimalSeparator = '.';
+    		};
+
+    		/**
+    		 * LazyScope < Scope < Expression < Statement
+    		 * @note The body is parsed on the first call to `get_body`, once even when called from several threads
+    		 * @note The body is optimized when `OPTI_CONST_EXPR` is set or `get_constexpr` was called on the scope
+    		 */
+    		class LazyScope : public daedalus::core::ast::Scope {
+    		public:
+    			/**
+    			 * @param parser The configuration to parse the body with, a snapshot the scope shares ownership of
+    			 * @param tokens The tokens of the body, ending with `EOF`
+    			 */
+    			LazyScope(std::shared_ptr<const Parser> parser, std::vector<daedalus::core::lexer::Token> tokens);
+
+    			virtual std::vector<std::shared_ptr<daedalus::core::ast::Expression>> get_body() override;
+    			virtual std::shared_ptr<daedalus::core::ast::Expression> get_constexpr() override;
+    			/**
+    			 * @note An unresolved scope lists its tokens instead of resolving itself
+    			 */
+    			virtual std::string repr(int indent = 0) override;
+    			/**
+    			 * @note An unresolved scope has no children, its body being hidden until resolved
+    			 */
+    			virtual std::vector<std::shared_ptr<daedalus::core::ast::Expression>> get_children() override;
+    			virtual bool has_hidden_children() override;
+    			virtual size_t get_footprint() override;
+
+    			/**
+    			 * Whether the body has been parsed
+    			 */
+    			bool is_resolved();
+
+    		private:
+    			void resolve();
+
+    			std::shared_ptr<const Parser> parser;
+    			std::vector<daedalus::core::lexer::Token> tokens;
+    			std::once_flag resolveFlag;
+    			std::atomic<bool> resolved;
+    			/**
+    			 * Whether the body must be optimized once parsed, even without `OPTI_CONST_EXPR`
+    			 */
+    			std::atomic<bool> optimize;
     		};
 
     		Node make_node(
@@ -51,6 +152,41 @@ namespace daedalus {
 
     		std::shared_ptr<daedalus::core::ast::Expression> parse_number_expression(Parser& parser, std::vector<daedalus::core::lexer::Token>& tokens, bool needsSemicolon);
 
+    		/**
+    		 * Parse a scope delimited by an opening and a closing token, lazily if `LAZY_SCOPES` is set
+    		 * @param parser The parser to use the configuration of
+    		 * @param tokens The tokens to parse, starting with `opener`
+    		 * @param opener The type of the token opening the scope
+    		 * @param closer The type of the token closing the scope
+    		 * @return The scope (a `LazyScope` in lazy mode)
+    		 * @note In lazy mode, the tokens up to the matching `closer` are only brace-matched
+    		 * @note In lazy mode, the scopes of a `parse` call share one copy of the parser configuration, later changes to `parser` do not reach them
+    		 */
+    		std::shared_ptr<daedalus::core::ast::Scope> parse_scope(
+    			Parser& parser,
+    			std::vector<daedalus::core::lexer::Token>& tokens,
+    			std::string opener = "{",
+    			std::string closer = "}"
+    		);
+
+    		/**
+    		 * Intern a node through the parser's pool when `INTERN_NODES` is set
+    		 * @param parser The parser to use the configuration of
+    		 * @param node The node to intern, its children having been interned already
+    		 * @return The shared node (or `node` itself when interning is disabled)
+    		 * @note Meant for custom node parsing functions, so their subtrees are shared bottom-up
+    		 */
+    		std::shared_ptr<daedalus::core::ast::Expression> intern_node(
+    			Parser& parser,
+    			std::shared_ptr<daedalus::core::ast::Expression> node
+    		);
+
+    		/**
+    		 * Get the node pool of a parser, creating it if needed
+    		 * @note Thread-safe, but copies made before the pool is created do not share it
+    		 */
+    		std::shared_ptr<NodePool> get_node_pool(Parser& parser);
+
     		void register_node(
     			Parser& parser,
     			std::string key,
@@ -79,6 +215,20 @@ namespace daedalus {
     			std::shared_ptr<daedalus::core::ast::Scope> program,
     			std::vector<daedalus::core::lexer::Token>& tokens
     		);
+
+    		/**
+    		 * Parse tokens into a program, without throwing on parsing errors
+    		 * @param parser The parser to use the configuration of
+    		 * @param program The program to fill
+    		 * @param tokens The tokens to parse, ending with `EOF`
+    		 * @return The error and the offset of the token it was raised at, the statements parsed before it being kept
+    		 * @note Errors thrown by node parsing functions are caught and converted into `PARSE_ERROR`s
+    		 */
+    		daedalus::core::tools::Result<void> try_parse(
+    			Parser& parser,
+    			std::shared_ptr<daedalus::core::ast::Scope> program,
+    			std::vector<daedalus::core::lexer::Token>& tokens
+    		);
     	}
     }
 }
@@ -0,0 +1,86 @@
+#ifndef __DAEDALUS_CORE_SESSION__
+#define __DAEDALUS_CORE_SESSION__
+
+#include <daedalus/core/core.hpp>
+#include <daedalus/core/tools/result.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace session {
+
+    		/**
+    		 * A long-lived interpreter state, evaluating source fragments one after the other
+    		 * @note Each fragment is lexed, parsed and evaluated on its own, in the root environment kept by the session
+    		 * @note A session is not thread-safe
+    		 */
+    		class Session {
+    		public:
+    			/**
+    			 * @param daedalus The configuration to use, which must outlive the session
+    			 * @param env The root environment to run in (a new one is created if `nullptr`), e.g. a fork of a prelude environment
+    			 */
+    			Session(
+    				daedalus::core::Daedalus& daedalus,
+    				std::shared_ptr<daedalus::core::env::Environment> env = nullptr
+    			);
+
+    			/**
+    			 * Evaluate a source fragment
+    			 * @param src The source fragment, made of complete top-level statements
+    			 * @return The results of the statements of the fragment only
+    			 * @throw The lexing or parsing error, nothing being evaluated, or the evaluation error, the statements evaluated before it being kept
+    			 */
+    			std::vector<daedalus::core::interpreter::RuntimeResult> feed(const std::string& src);
+
+    			/**
+    			 * Evaluate a source fragment, without throwing
+    			 * @param src The source fragment, made of complete top-level statements
+    			 * @return The results of the statements of the fragment, or the error (offsets being relative to the fragment)
+    			 * @note As with `feed`, the statements evaluated before an evaluation error are kept
+    			 */
+    			daedalus::core::tools::Result<std::vector<daedalus::core::interpreter::RuntimeResult>> try_feed(const std::string& src);
+
+    			std::shared_ptr<daedalus::core::env::Environment> get_env();
+
+    			/**
+    			 * Get the statements evaluated so far, in order
+    			 */
+    			std::shared_ptr<daedalus::core::ast::Scope> get_program();
+
+    			/**
+    			 * Number of fragments evaluated so far, failed ones included
+    			 */
+    			size_t get_fragment_count();
+
+    			/**
+    			 * Drop the evaluated statements and start again from a new root environment
+    			 * @param env The root environment to run in (a new one is created if `nullptr`)
+    			 */
+    			void reset(std::shared_ptr<daedalus::core::env::Environment> env = nullptr);
+
+    		private:
+    			/**
+    			 * Add the evaluated statements of a fragment to the program
+    			 */
+    			void commit(
+    				const std::vector<std::shared_ptr<daedalus::core::ast::Expression>>& body,
+    				size_t evaluated
+    			);
+
+    			std::shared_ptr<daedalus::core::env::Environment> make_env();
+
+    			daedalus::core::Daedalus& daedalus;
+    			std::shared_ptr<daedalus::core::env::Environment> env;
+    			std::shared_ptr<daedalus::core::ast::Scope> program;
+    			size_t fragmentCount;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_CORE_SESSION__
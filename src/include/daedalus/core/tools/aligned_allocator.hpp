@@ -0,0 +1,56 @@
+#ifndef __DAEDALUS_ALIGNED_ALLOCATOR__
+#define __DAEDALUS_ALIGNED_ALLOCATOR__
+
+#include <daedalus/core/tools/allocation_tracker.hpp>
+
+#include <cstddef>
+#include <new>
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		/**
+    		 * A standard allocator returning memory aligned on `Alignment` bytes
+    		 * @note Used to back SIMD-friendly containers
+    		 */
+    		template<typename T, size_t Alignment>
+    		class AlignedAllocator {
+    		public:
+    			typedef T value_type;
+
+    			template<typename U>
+    			struct rebind {
+    				typedef AlignedAllocator<U, Alignment> other;
+    			};
+
+    			AlignedAllocator() noexcept {}
+
+    			template<typename U>
+    			AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    			[[nodiscard]] T* allocate(size_t n) {
+    				daedalus::core::tools::notify_allocation(n * sizeof(T));
+    				return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    			}
+
+    			void deallocate(T* pointer, size_t n) noexcept {
+    				daedalus::core::tools::notify_deallocation(n * sizeof(T));
+    				::operator delete(pointer, std::align_val_t(Alignment));
+    			}
+
+    			template<typename U>
+    			bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+    				return true;
+    			}
+
+    			template<typename U>
+    			bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+    				return false;
+    			}
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_ALIGNED_ALLOCATOR__
@@ -0,0 +1,232 @@
+#ifndef __DAEDALUS_ALLOCATION_TRACKER__
+#define __DAEDALUS_ALLOCATION_TRACKER__
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * Number of values of `PipelinePhase`
+ */
+#define DAE_PIPELINE_PHASE_COUNT 5
+
+/**
+ * Replace the global `operator new` and `operator delete` so every heap allocation reaches the allocation hooks
+ * @note Use it once, at namespace scope, in a single translation unit of the executable
+ * @note Each block gets a small header holding its size, so only enable it for measurement builds
+ */
+#define DAE_TRACK_GLOBAL_ALLOCATIONS \
+void* operator new(std::size_t size) { return daedalus::core::tools::tracked_allocate(size); } \
+void* operator new[](std::size_t size) { return daedalus::core::tools::tracked_allocate(size); } \
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return daedalus::core::tools::tracked_allocate(size, std::nothrow); } \
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return daedalus::core::tools::tracked_allocate(size, std::nothrow); } \
+void operator delete(void* block) noexcept { daedalus::core::tools::tracked_deallocate(block); } \
+void operator delete[](void* block) noexcept { daedalus::core::tools::tracked_deallocate(block); } \
+void operator delete(void* block, std::size_t) noexcept { daedalus::core::tools::tracked_deallocate(block); } \
+void operator delete[](void* block, std::size_t) noexcept { daedalus::core::tools::tracked_deallocate(block); } \
+void operator delete(void* block, const std::nothrow_t&) noexcept { daedalus::core::tools::tracked_deallocate(block); } \
+void operator delete[](void* block, const std::nothrow_t&) noexcept { daedalus::core::tools::tracked_deallocate(block); }
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		/**
+    		 * The stage of the pipeline allocations are attributed to
+    		 */
+    		enum class PipelinePhase {
+    			NONE,
+    			LEXER,
+    			PARSER,
+    			OPTIMIZER,
+    			INTERPRETER,
+    		};
+
+    		/**
+    		 * Get the phase the calling thread is in
+    		 */
+    		PipelinePhase get_pipeline_phase();
+
+    		/**
+    		 * Set the phase the calling thread is in
+    		 */
+    		void set_pipeline_phase(PipelinePhase phase);
+
+    		/**
+    		 * A phase lasting as long as the object, the previous phase being restored afterwards
+    		 */
+    		class PipelinePhaseScope {
+    		public:
+    			PipelinePhaseScope(PipelinePhase phase);
+    			~PipelinePhaseScope();
+
+    			PipelinePhaseScope(const PipelinePhaseScope&) = delete;
+    			PipelinePhaseScope& operator=(const PipelinePhaseScope&) = delete;
+
+    		private:
+    			PipelinePhase previous;
+    		};
+
+    		/**
+    		 * Functions notified of every tracked allocation
+    		 * @note The hooks can be called from any thread and from inside `operator new`, they must not allocate
+    		 */
+    		typedef struct AllocationHooks {
+    			void (*on_allocate)(void* userData, size_t size);
+    			void (*on_deallocate)(void* userData, size_t size);
+    			void* userData;
+    		} AllocationHooks;
+
+    		/**
+    		 * Install the allocation hooks (`nullptr` to uninstall them)
+    		 * @note The hooks must outlive their installation, replacing or uninstalling them waits for their calls in progress
+    		 */
+    		void set_allocation_hooks(const AllocationHooks* hooks);
+
+    		/**
+    		 * Notify the installed hooks of an allocation
+    		 */
+    		void notify_allocation(size_t size);
+
+    		/**
+    		 * Notify the installed hooks of a deallocation
+    		 */
+    		void notify_deallocation(size_t size);
+
+    		/**
+    		 * Stop notifying the hooks on the calling thread as long as the object lives
+    		 * @note Allocators already notifying their own blocks use it around their calls to the heap
+    		 */
+    		class UntrackedScope {
+    		public:
+    			UntrackedScope();
+    			~UntrackedScope();
+
+    			UntrackedScope(const UntrackedScope&) = delete;
+    			UntrackedScope& operator=(const UntrackedScope&) = delete;
+    		};
+
+    		/**
+    		 * Allocate a block from the heap, notifying the hooks
+    		 * @throw std::bad_alloc if the heap is exhausted
+    		 */
+    		void* tracked_allocate(size_t size);
+
+    		/**
+    		 * Allocate a block from the heap, notifying the hooks
+    		 * @return The block, or `nullptr` if the heap is exhausted
+    		 */
+    		void* tracked_allocate(size_t size, const std::nothrow_t&) noexcept;
+
+    		/**
+    		 * Give a block allocated by `tracked_allocate` back to the heap, notifying the hooks
+    		 */
+    		void tracked_deallocate(void* block) noexcept;
+
+    		/**
+    		 * The allocations attributed to a phase
+    		 */
+    		typedef struct PhaseAllocations {
+    			size_t allocations;
+    			size_t deallocations;
+    			size_t allocatedBytes;
+    			size_t freedBytes;
+    			/**
+    			 * Blocks allocated since the tracker started and still live at the end of the phase, every phase included
+    			 * @note Negative when more blocks allocated before the start were freed
+    			 */
+    			long long liveAllocations;
+    			long long liveBytes;
+    		} PhaseAllocations;
+
+    		/**
+    		 * A tracker attributing allocations to the phase of the thread doing them
+    		 * @note A single tracker can run per process, the hooks being global
+    		 */
+    		class AllocationTracker {
+    		public:
+    			AllocationTracker();
+    			~AllocationTracker();
+
+    			AllocationTracker(const AllocationTracker&) = delete;
+    			AllocationTracker& operator=(const AllocationTracker&) = delete;
+
+    			/**
+    			 * Reset the counters and install the tracker's hooks
+    			 * @throw std::runtime_error if another tracker is running
+    			 */
+    			void start();
+
+    			/**
+    			 * Uninstall the tracker's hooks, waiting for their calls in progress on other threads
+    			 */
+    			void stop();
+
+    			/**
+    			 * Record the live allocations at the end of a phase
+    			 */
+    			void end_phase(PipelinePhase phase);
+
+    			/**
+    			 * Get the allocations attributed to a phase
+    			 */
+    			PhaseAllocations get_phase(PipelinePhase phase) const;
+
+    			/**
+    			 * Get the string representation of the counters of every phase
+    			 */
+    			std::string repr() const;
+
+    		private:
+    			typedef struct Counters {
+    				std::atomic<size_t> allocations;
+    				std::atomic<size_t> deallocations;
+    				std::atomic<size_t> allocatedBytes;
+    				std::atomic<size_t> freedBytes;
+    				std::atomic<long long> liveAllocations;
+    				std::atomic<long long> liveBytes;
+    			} Counters;
+
+    			static void on_allocate(void* userData, size_t size);
+    			static void on_deallocate(void* userData, size_t size);
+
+    			AllocationHooks hooks;
+    			Counters phases[DAE_PIPELINE_PHASE_COUNT];
+    			std::atomic<long long> liveAllocations;
+    			std::atomic<long long> liveBytes;
+    		};
+
+    		/**
+    		 * The allocations allowed in a phase
+    		 */
+    		typedef struct AllocationBudget {
+    			PipelinePhase phase;
+    			size_t maxAllocations = std::numeric_limits<size_t>::max();
+    			size_t maxBytes = std::numeric_limits<size_t>::max();
+    			/**
+    			 * Bytes allowed to be live at the end of the phase
+    			 */
+    			long long maxLiveBytes = std::numeric_limits<long long>::max();
+    		} AllocationBudget;
+
+    		/**
+    		 * Check the allocations of a tracker against budgets
+    		 * @return A description of each exceeded limit (empty when every budget holds)
+    		 */
+    		std::vector<std::string> check_allocation_budgets(
+    			const AllocationTracker& tracker,
+    			const std::vector<AllocationBudget>& budgets
+    		);
+
+    		/**
+    		 * Get the name of a phase
+    		 */
+    		std::string repr(PipelinePhase phase);
+    	}
+    }
+}
+
+#endif // __DAEDALUS_ALLOCATION_TRACKER__
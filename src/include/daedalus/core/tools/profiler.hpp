@@ -0,0 +1,126 @@
+#ifndef __DAEDALUS_PROFILER__
+#define __DAEDALUS_PROFILER__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Whether profiling hooks should run for a given profiler
+ * @note Define `DAE_NO_PROFILER` to compile every hook out
+ */
+#ifndef DAE_NO_PROFILER
+
+#define DAE_PROFILING(profiler) \
+((profiler) != nullptr)
+
+#else
+
+#define DAE_PROFILING(profiler) \
+false
+
+#endif
+
+/**
+ * Frame names used for the environment operations
+ */
+#define DAE_PROFILE_ENV_GET "Environment::get_value"
+#define DAE_PROFILE_ENV_SET "Environment::set_value"
+#define DAE_PROFILE_ENV_INIT "Environment::init_value"
+#define DAE_PROFILE_ENV_VALIDATION "EnvValidationRule"
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		/**
+    		 * The statistics of a profiled frame name
+    		 */
+    		typedef struct ProfileEntry {
+    			size_t calls;
+    			/**
+    			 * Time spent in the frame, children included (recursive calls are only counted once)
+    			 */
+    			uint64_t inclusiveNs;
+    			/**
+    			 * Time spent in the frame itself
+    			 */
+    			uint64_t exclusiveNs;
+    		} ProfileEntry;
+
+    		/**
+    		 * A profiler recording the time spent per node type and environment operation
+    		 * @note A profiler is not thread-safe, only enable it on interpreters evaluating from a single thread
+    		 */
+    		class Profiler {
+    		public:
+    			/**
+    			 * Start a frame
+    			 * @param name The name of the frame (node type, environment operation...)
+    			 */
+    			void enter(const std::string& name);
+
+    			/**
+    			 * End the last started frame
+    			 */
+    			void exit();
+
+    			/**
+    			 * Get the statistics per frame name
+    			 */
+    			const std::unordered_map<std::string, ProfileEntry>& get_entries();
+
+    			/**
+    			 * Get the statistics of a frame name (zeroes if never entered)
+    			 */
+    			ProfileEntry get_entry(const std::string& name);
+
+    			/**
+    			 * Export the exclusive time of each stack in the collapsed format read by flame graph tools
+    			 * @return One `frame;frame;frame nanoseconds` line per stack
+    			 */
+    			std::string collapsed_stacks();
+
+    			/**
+    			 * Drop every recorded statistic
+    			 */
+    			void reset();
+
+    		private:
+    			typedef struct Frame {
+    				std::string name;
+    				std::string stack;
+    				uint64_t start;
+    				uint64_t childrenNs;
+    			} Frame;
+
+    			std::vector<Frame> frames;
+    			std::unordered_map<std::string, ProfileEntry> entries;
+    			std::unordered_map<std::string, uint64_t> stacks;
+    			/**
+    			 * Number of frames currently open per name, to avoid counting recursive calls twice
+    			 */
+    			std::unordered_map<std::string, size_t> openFrames;
+    		};
+
+    		/**
+    		 * A frame lasting as long as the object
+    		 */
+    		class ProfileScope {
+    		public:
+    			ProfileScope(Profiler& profiler, const std::string& name);
+    			~ProfileScope();
+
+    			ProfileScope(const ProfileScope&) = delete;
+    			ProfileScope& operator=(const ProfileScope&) = delete;
+
+    		private:
+    			Profiler& profiler;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_PROFILER__
@@ -0,0 +1,131 @@
+#ifndef __DAEDALUS_RESULT__
+#define __DAEDALUS_RESULT__
+
+#include <daedalus/core/tools/assert.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		enum class ErrorCode {
+    			UNKNOWN_TOKEN,
+    			UNCLOSED_COMMENT,
+    			UNOPENED_COMMENT,
+    			/**
+    			 * A top-level statement no node could parse
+    			 */
+    			UNKNOWN_NODE,
+    			/**
+    			 * An error thrown by a node parsing function
+    			 */
+    			PARSE_ERROR,
+    			/**
+    			 * A number token that could not be converted
+    			 */
+    			INVALID_NUMBER,
+    			/**
+    			 * A node type without evaluation function
+    			 */
+    			UNKNOWN_STATEMENT,
+    			/**
+    			 * An error thrown by an evaluation function
+    			 */
+    			EVALUATION_ERROR,
+    			/**
+    			 * A source file that could not be read
+    			 */
+    			READ_ERROR,
+    		};
+
+    		/**
+    		 * A structured error, formatted only on demand
+    		 */
+    		typedef struct Error {
+    			ErrorCode code;
+    			/**
+    			 * The offset of the error in the source for lexing and parsing errors, the index of the top-level statement for evaluation errors
+    			 */
+    			size_t offset;
+    			/**
+    			 * The message of the exception the error comes from (empty for errors detected without exceptions)
+    			 */
+    			std::string detail = "";
+    		} Error;
+
+    		/**
+    		 * Get the message of an error
+    		 * @param error The error to format
+    		 * @param src The source string the error comes from, to report its line, column and a short excerpt (can be empty)
+    		 * @return The message
+    		 */
+    		std::string format_error(const Error& error, const std::string& src = "");
+
+    		/**
+    		 * Either a value or an error
+    		 */
+    		template<typename T>
+    		class Result {
+    		public:
+    			Result(T value) : content(std::move(value)) {}
+    			Result(Error error) : content(std::move(error)) {}
+
+    			bool ok() const {
+    				return this->content.index() == 0;
+    			}
+
+    			explicit operator bool() const {
+    				return this->ok();
+    			}
+
+    			T& value() {
+    				DAE_ASSERT_TRUE(
+    					this->ok(),
+    					std::runtime_error(format_error(std::get<Error>(this->content)))
+    				)
+    				return std::get<T>(this->content);
+    			}
+
+    			const Error& error() const {
+    				return std::get<Error>(this->content);
+    			}
+
+    		private:
+    			std::variant<T, Error> content;
+    		};
+
+    		/**
+    		 * Either nothing or an error
+    		 */
+    		template<>
+    		class Result<void> {
+    		public:
+    			Result() : content(std::nullopt) {}
+    			Result(Error error) : content(std::move(error)) {}
+
+    			bool ok() const {
+    				return !this->content.has_value();
+    			}
+
+    			explicit operator bool() const {
+    				return this->ok();
+    			}
+
+    			const Error& error() const {
+    				return *this->content;
+    			}
+
+    		private:
+    			std::optional<Error> content;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_RESULT__
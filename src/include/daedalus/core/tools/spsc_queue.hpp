@@ -0,0 +1,91 @@
+#ifndef __DAEDALUS_SPSC_QUEUE__
+#define __DAEDALUS_SPSC_QUEUE__
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		/**
+    		 * A bounded lock-free queue between a single producer thread and a single consumer thread
+    		 * @note The capacity is rounded up to a power of two
+    		 */
+    		template<typename T>
+    		class SpscQueue {
+    		public:
+    			explicit SpscQueue(size_t capacity) :
+    				slots(round_up(capacity)),
+    				mask(round_up(capacity) - 1)
+    			{}
+
+    			SpscQueue(const SpscQueue&) = delete;
+    			SpscQueue& operator=(const SpscQueue&) = delete;
+
+    			/**
+    			 * Push a value (producer only)
+    			 * @return Whether the value was pushed, it is left untouched when the queue is full
+    			 */
+    			template<typename U>
+    			bool try_push(U&& value) {
+    				size_t tail = this->tail.load(std::memory_order_relaxed);
+    				if(tail - this->headCache == this->slots.size()) {
+    					this->headCache = this->head.load(std::memory_order_acquire);
+    					if(tail - this->headCache == this->slots.size()) {
+    						return false;
+    					}
+    				}
+
+    				this->slots[tail & this->mask] = std::forward<U>(value);
+    				this->tail.store(tail + 1, std::memory_order_release);
+    				return true;
+    			}
+
+    			/**
+    			 * Pop a value (consumer only)
+    			 * @return Whether a value was popped into `value`
+    			 */
+    			bool try_pop(T& value) {
+    				size_t head = this->head.load(std::memory_order_relaxed);
+    				if(head == this->tailCache) {
+    					this->tailCache = this->tail.load(std::memory_order_acquire);
+    					if(head == this->tailCache) {
+    						return false;
+    					}
+    				}
+
+    				value = std::move(this->slots[head & this->mask]);
+    				this->head.store(head + 1, std::memory_order_release);
+    				return true;
+    			}
+
+    			size_t capacity() const {
+    				return this->slots.size();
+    			}
+
+    		private:
+    			static size_t round_up(size_t capacity) {
+    				size_t rounded = 1;
+    				while(rounded < capacity) {
+    					rounded <<= 1;
+    				}
+    				return rounded;
+    			}
+
+    			std::vector<T> slots;
+    			size_t mask;
+
+    			// Each side owns a cache line: its index and its cached copy of the other side's index
+    			alignas(64) std::atomic<size_t> head = 0;
+    			size_t tailCache = 0;
+    			alignas(64) std::atomic<size_t> tail = 0;
+    			size_t headCache = 0;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_SPSC_QUEUE__
@@ -0,0 +1,109 @@
+#ifndef __DAEDALUS_THREAD_POOL__
+#define __DAEDALUS_THREAD_POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		typedef struct ThreadPoolStats {
+    			size_t executed;
+    			/**
+    			 * Tasks run by another thread than the one whose queue they were pushed to
+    			 */
+    			size_t stolen;
+    		} ThreadPoolStats;
+
+    		/**
+    		 * A work-stealing thread pool
+    		 * @note Each worker owns a queue, running its own tasks newest first and stealing the oldest tasks of the others when it runs out
+    		 * @note Tasks submitted from a worker go to its own queue, the others are spread over the workers
+    		 */
+    		class ThreadPool {
+    		public:
+    			typedef std::function<void ()> Task;
+
+    			/**
+    			 * @param threadCount Number of worker threads (`0` to use the hardware concurrency)
+    			 */
+    			explicit ThreadPool(size_t threadCount = 0);
+    			~ThreadPool();
+
+    			ThreadPool(const ThreadPool&) = delete;
+    			ThreadPool& operator=(const ThreadPool&) = delete;
+
+    			void submit(Task task);
+
+    			/**
+    			 * Wait for every submitted task to finish, running tasks on the calling thread meanwhile
+    			 * @throw The first exception thrown by a task since the last call
+    			 * @note Must not be called from a task, which would wait for itself
+    			 */
+    			void wait();
+
+    			/**
+    			 * Run tasks on the calling thread until a condition holds, without waiting for the other tasks of the pool
+    			 * @param done The condition, checked whenever a task finishes
+    			 * @note Can be called from a task, the task helping with the queued tasks instead of blocking a worker
+    			 */
+    			void wait_until(const std::function<bool ()>& done);
+
+    			size_t get_thread_count();
+
+    			ThreadPoolStats get_stats();
+
+    		private:
+    			typedef struct WorkerQueue {
+    				std::mutex mutex;
+    				std::deque<Task> tasks;
+    			} WorkerQueue;
+
+    			/**
+    			 * Run a single task, from the queue of a worker first
+    			 * @param worker The index of the queue to start with (the number of workers for threads outside of the pool)
+    			 * @return Whether a task was run
+    			 */
+    			bool run_one(size_t worker);
+
+    			void work(size_t worker);
+
+    			std::vector<std::unique_ptr<WorkerQueue>> queues;
+    			std::vector<std::thread> threads;
+
+    			std::mutex mutex;
+    			std::condition_variable wake;
+    			std::condition_variable idle;
+    			/**
+    			 * Tasks waiting in a queue
+    			 */
+    			std::atomic<size_t> queued;
+    			/**
+    			 * Tasks waiting or running
+    			 */
+    			std::atomic<size_t> pending;
+    			/**
+    			 * Threads blocked in `wait_until`, notified whenever a task finishes
+    			 */
+    			std::atomic<size_t> conditionWaiters;
+    			std::atomic<size_t> nextQueue;
+    			bool stopping;
+
+    			std::atomic<size_t> executed;
+    			std::atomic<size_t> stolen;
+    			std::exception_ptr error;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_THREAD_POOL__
@@ -0,0 +1,184 @@
+#ifndef __DAEDALUS_TRACE__
+#define __DAEDALUS_TRACE__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Number of events kept per thread by default, the oldest ones being overwritten
+ */
+#define DAE_TRACE_DEFAULT_CAPACITY 65536
+
+/**
+ * Number of distinct names kept for the whole process, later names being all recorded as `DAE_TRACE_OTHER_NAME`
+ */
+#ifndef DAE_TRACE_MAX_NAMES
+#define DAE_TRACE_MAX_NAMES 65536
+#endif
+
+/**
+ * The id of the name shared by every error event
+ */
+#define DAE_TRACE_ERROR_NAME 0
+
+/**
+ * The id of the name shared by the events recorded once the names are full
+ */
+#define DAE_TRACE_OTHER_NAME 1
+
+/**
+ * Whether tracing hooks should record events
+ * @note Define `DAE_NO_TRACE` to compile every hook out
+ */
+#ifndef DAE_NO_TRACE
+
+#define DAE_TRACING() \
+(daedalus::core::tools::tracingEnabled.load(std::memory_order_relaxed))
+
+#else
+
+#define DAE_TRACING() \
+false
+
+#endif
+
+namespace daedalus {
+    namespace core {
+    	namespace tools {
+
+    		enum class TraceEventType : uint8_t {
+    			NODE_ENTER,
+    			NODE_EXIT,
+    			ENV_GET,
+    			ENV_SET,
+    			ENV_INIT,
+    			VALIDATION_RULE,
+    			/**
+    			 * An error stopping an evaluation, always named `DAE_TRACE_ERROR_NAME` so messages do not fill the names
+    			 */
+    			ERROR,
+    		};
+
+    		/**
+    		 * A fixed-size binary event
+    		 */
+    		typedef struct TraceEvent {
+    			/**
+    			 * Nanoseconds since an arbitrary, process-wide origin
+    			 */
+    			uint64_t timestamp;
+    			/**
+    			 * The id of the node type, key or message (see `TraceDump::names`)
+    			 */
+    			uint32_t name;
+    			uint16_t thread;
+    			TraceEventType type;
+    		} TraceEvent;
+
+    		/**
+    		 * The events of every thread, and the names they refer to
+    		 */
+    		typedef struct TraceDump {
+    			/**
+    			 * The events, sorted by timestamp
+    			 */
+    			std::vector<TraceEvent> events;
+    			std::vector<std::string> names;
+    		} TraceDump;
+
+    		extern std::atomic<bool> tracingEnabled;
+
+    		/**
+    		 * Start recording events
+    		 * @param capacity Number of events kept per thread (rounded up to a power of two), for the threads recording their first event afterwards
+    		 */
+    		void enable_tracing(size_t capacity = DAE_TRACE_DEFAULT_CAPACITY);
+
+    		/**
+    		 * Stop recording events, the recorded ones being kept
+    		 */
+    		void disable_tracing();
+
+    		/**
+    		 * Get the id of a name, the names being kept for the whole process
+    		 * @note Past `DAE_TRACE_MAX_NAMES` names, new names get `DAE_TRACE_OTHER_NAME`
+    		 */
+    		uint32_t trace_name(const std::string& name);
+
+    		/**
+    		 * Record an event in the calling thread's ring buffer
+    		 * @note Lock-free once the calling thread recorded its first event, call it behind `DAE_TRACING()`
+    		 */
+    		void trace(TraceEventType type, uint32_t name);
+
+    		void trace(TraceEventType type, const std::string& name);
+
+    		/**
+    		 * Copy the events currently held by the ring buffers
+    		 * @note Can be called while other threads record, events overwritten during the copy (checked by a per-slot stamp) being skipped
+    		 */
+    		TraceDump dump_trace();
+
+    		/**
+    		 * Drop the recorded events
+    		 * @note Must not be called while other threads record
+    		 */
+    		void clear_trace();
+
+    		/**
+    		 * Set the file the trace is written to when an evaluation fails while tracing (empty to disable)
+    		 */
+    		void set_trace_error_path(const std::string& path);
+
+    		/**
+    		 * Record an error and write the trace to the error path, if any
+    		 */
+    		void trace_error();
+
+    		/**
+    		 * Write a dump in the binary format read by `read_trace`
+    		 * @note Numbers are written in the byte order of the machine
+    		 */
+    		void write_trace(const TraceDump& dump, std::ostream& out);
+
+    		/**
+    		 * Read a dump written by `write_trace`
+    		 * @throw std::runtime_error if the input is not a valid trace
+    		 */
+    		TraceDump read_trace(std::istream& in);
+
+    		/**
+    		 * Decode a dump into one readable line per event, timestamps being relative to the first event
+    		 */
+    		std::string trace_to_text(const TraceDump& dump);
+
+    		/**
+    		 * Decode a dump into the JSON format read by `chrome://tracing` and Perfetto
+    		 */
+    		std::string trace_to_chrome_json(const TraceDump& dump);
+
+    		/**
+    		 * A node enter event, and its exit event when the object is destroyed
+    		 */
+    		class TraceNodeScope {
+    		public:
+    			TraceNodeScope(uint32_t name);
+    			TraceNodeScope(const std::string& name);
+    			~TraceNodeScope();
+
+    			TraceNodeScope(const TraceNodeScope&) = delete;
+    			TraceNodeScope& operator=(const TraceNodeScope&) = delete;
+
+    		private:
+    			uint32_t name;
+    		};
+    	}
+    }
+}
+
+#endif // __DAEDALUS_TRACE__